@@ -0,0 +1,159 @@
+// 音频增益内核基准：逐个内核计时 ApplyGainS16 / MixS16，并检查结果与标量实现逐位一致。
+// 固定增益的 Apply 另外与改写前的浮点实现比较（取整方式不同，允许相差1）。
+// 用法：AudioGainBench [样本数] [重复次数]
+#include "core/baseItem/AudioGain.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace core;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 一组输入与增益：固定增益、音量渐变、静音与满音量（满音量的 Apply 不修改数据）
+struct Case {
+    const char* name;
+    int startGain;
+    int endGain;
+};
+
+constexpr Case kCases[] = {
+    { "gain 0.5", kUnityGain / 2, kUnityGain / 2 },
+    { "ramp 1.0->0.25", kUnityGain, kUnityGain / 4 },
+    { "mute", 0, 0 },
+    { "unity", kUnityGain, kUnityGain },
+};
+
+std::vector<int16_t> MakeSamples(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> dist(-32768, 32767);
+    std::vector<int16_t> samples(count);
+    for (int16_t& s : samples) s = static_cast<int16_t>(dist(rng));
+    // 两端放入极值，覆盖饱和路径
+    samples[0] = -32768;
+    samples[count - 1] = 32767;
+    return samples;
+}
+
+// 改写前 VideoPlayer::applyVolume 的实现：逐样本转为浮点、相乘、分支限幅，截断取整
+void ApplyVolumeFloat(int16_t* samples, size_t count, float volume) {
+    if (volume >= 1.0f) return;
+    for (size_t i = 0; i < count; i++) {
+        float sample = static_cast<float>(samples[i]) * volume;
+        if (sample > 32767.0f) {
+            samples[i] = 32767;
+        } else if (sample < -32768.0f) {
+            samples[i] = -32768;
+        } else {
+            samples[i] = static_cast<int16_t>(sample);
+        }
+    }
+}
+
+// 两组样本的最大差值
+int MaxDifference(const std::vector<int16_t>& a, const std::vector<int16_t>& b) {
+    int maxDiff = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        maxDiff = std::max(maxDiff, std::abs(static_cast<int>(a[i]) - static_cast<int>(b[i])));
+    }
+    return maxDiff;
+}
+
+// 按当前内核计算一遍结果
+void Run(const Case& c, bool mix, const std::vector<int16_t>& src, const std::vector<int16_t>& base,
+         std::vector<int16_t>& out) {
+    out = mix ? base : src;
+    if (mix) MixS16(out.data(), src.data(), out.size(), c.startGain, c.endGain);
+    else ApplyGainS16(out.data(), out.size(), c.startGain, c.endGain);
+}
+
+// 每次从相同的输入开始，复制不计入时间
+template <typename Fn>
+double TimeMs(const std::vector<int16_t>& input, std::vector<int16_t>& work, int repeats, Fn run) {
+    double total = 0.0;
+    for (int r = 0; r < repeats; ++r) {
+        work = input;
+        const auto start = Clock::now();
+        run(work);
+        total += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+    return total;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // 默认 1M 个样本（约 11 秒的 48kHz 立体声）；奇数长度覆盖尾部的标量处理
+    const size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : (1u << 20) + 7;
+    const int repeats = argc > 2 ? std::atoi(argv[2]) : 100;
+    if (count < 2 || repeats < 1) {
+        std::fprintf(stderr, "usage: AudioGainBench [samples>=2] [repeats>=1]\n");
+        return 2;
+    }
+
+    const std::vector<int16_t> src = MakeSamples(count, 1);
+    const std::vector<int16_t> base = MakeSamples(count, 2);
+    std::vector<int16_t> expected;
+    std::vector<int16_t> actual;
+    std::vector<int16_t> work;
+
+    const AudioKernel detected = GetAudioKernel();
+    std::printf("samples %zu, repeats %d, detected kernel %s\n", count, repeats, GetAudioKernelName(detected));
+
+    int mismatches = 0;
+    for (const bool mix : { false, true }) {
+        for (const Case& c : kCases) {
+            std::printf("%s %s\n", mix ? "MixS16" : "ApplyGainS16", c.name);
+            SetAudioKernel(AudioKernel::Scalar);
+            Run(c, mix, src, base, expected);
+
+            // 改写前只有固定音量的 applyVolume，没有渐变与混音
+            double floatMs = 0.0;
+            if (!mix && c.startGain == c.endGain) {
+                const float volume = static_cast<float>(c.startGain) / kUnityGain;
+                actual = src;
+                ApplyVolumeFloat(actual.data(), count, volume);
+                const int maxDiff = MaxDifference(actual, expected);
+                if (maxDiff > 1) mismatches++;
+                floatMs = TimeMs(src, work, repeats, [&](std::vector<int16_t>& w) {
+                    ApplyVolumeFloat(w.data(), w.size(), volume);
+                });
+                const double samplesPerSecond = static_cast<double>(count) * repeats / (floatMs / 1000.0);
+                std::printf("  %-6s %9.2f ms  %8.1f Msamples/s  %-6s %s (max diff %d)\n", "float", floatMs,
+                            samplesPerSecond / 1e6, "", maxDiff <= 1 ? "within 1" : "MISMATCH", maxDiff);
+            }
+
+            double scalarMs = 0.0;
+            for (AudioKernel kernel : { AudioKernel::Scalar, AudioKernel::SSE2, AudioKernel::AVX2, AudioKernel::NEON }) {
+                if (!SetAudioKernel(kernel)) continue;
+                Run(c, mix, src, base, actual);
+                const bool exact = std::memcmp(actual.data(), expected.data(), count * sizeof(int16_t)) == 0;
+                if (!exact) mismatches++;
+                const double ms = TimeMs(mix ? base : src, work, repeats, [&](std::vector<int16_t>& w) {
+                    if (mix) MixS16(w.data(), src.data(), w.size(), c.startGain, c.endGain);
+                    else ApplyGainS16(w.data(), w.size(), c.startGain, c.endGain);
+                });
+                if (kernel == AudioKernel::Scalar) scalarMs = ms;
+                const double samplesPerSecond = static_cast<double>(count) * repeats / (ms / 1000.0);
+                std::printf("  %-6s %9.2f ms  %8.1f Msamples/s  x%-5.2f %s", GetAudioKernelName(kernel), ms,
+                            samplesPerSecond / 1e6, ms > 0.0 ? scalarMs / ms : 0.0, exact ? "exact" : "MISMATCH");
+                if (floatMs > 0.0 && ms > 0.0) std::printf("  x%.2f vs float", floatMs / ms);
+                std::printf("\n");
+            }
+        }
+    }
+    SetAudioKernel(detected);
+
+    if (mismatches > 0) {
+        std::fprintf(stderr, "%d results differ from the scalar reference (or the float baseline by more than 1)\n", mismatches);
+        return 1;
+    }
+    return 0;
+}
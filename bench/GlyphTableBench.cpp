@@ -0,0 +1,128 @@
+// 字形表基准：比较 GlyphTable 与 std::map / std::unordered_map 在排版时逐字符查找的耗时。
+// 用法：GlyphTableBench [文本长度] [重复次数]
+#include "core/baseItem/GlyphTable.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace core;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 与 Character 大小相近的值类型（度量 + 图集位置），不依赖 FreeType
+struct GlyphValue {
+    float metrics[12];
+};
+
+// 文本由字符集中按近似使用频率抽取的字符组成
+std::wstring MakeText(const std::vector<wchar_t>& charset, size_t length, unsigned seed) {
+    std::mt19937 rng(seed);
+    // 几何分布：靠前的字符出现得更频繁，与常用字的分布相近
+    std::geometric_distribution<size_t> pick(8.0 / static_cast<double>(charset.size()));
+    std::wstring text;
+    text.reserve(length);
+    while (text.size() < length) {
+        text.push_back(charset[pick(rng) % charset.size()]);
+    }
+    return text;
+}
+
+std::vector<wchar_t> AsciiSet() {
+    std::vector<wchar_t> set;
+    for (wchar_t c = 0x20; c < 0x7F; ++c) set.push_back(c);
+    return set;
+}
+
+std::vector<wchar_t> CjkSet() {
+    // 常用汉字所在的统一表意文字区间，外加中文标点
+    std::vector<wchar_t> set;
+    for (wchar_t c = 0x4E00; c < 0x4E00 + 3500; ++c) set.push_back(c);
+    for (wchar_t c = 0x3000; c < 0x3020; ++c) set.push_back(c);
+    return set;
+}
+
+std::vector<wchar_t> MixedSet() {
+    std::vector<wchar_t> set = AsciiSet();
+    const std::vector<wchar_t> cjk = CjkSet();
+    set.insert(set.end(), cjk.begin(), cjk.end());
+    // BMP 以外的字符（表情、扩展汉字）只在 wchar_t 为32位的平台上出现
+    if constexpr (sizeof(wchar_t) >= 4) {
+        for (uint32_t c = 0x1F600; c < 0x1F650; ++c) set.push_back(static_cast<wchar_t>(c));
+        for (uint32_t c = 0x20000; c < 0x20100; ++c) set.push_back(static_cast<wchar_t>(c));
+    }
+    // 打乱顺序，使常用字符来自各个区间
+    std::shuffle(set.begin(), set.end(), std::mt19937(7));
+    return set;
+}
+
+template <typename Lookup>
+double TimeMs(const std::wstring& text, int repeats, Lookup lookup, float& sink) {
+    const auto start = Clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        for (wchar_t c : text) {
+            sink += lookup(c);
+        }
+    }
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void RunCase(const char* name, const std::vector<wchar_t>& charset, size_t length, int repeats) {
+    GlyphTable<GlyphValue> table;
+    std::map<wchar_t, GlyphValue> ordered;
+    std::unordered_map<wchar_t, GlyphValue> hashed;
+    for (wchar_t c : charset) {
+        GlyphValue value{};
+        value.metrics[0] = static_cast<float>(static_cast<uint32_t>(c) & 0xFF);
+        table.InsertOrAssign(c, value);
+        ordered[c] = value;
+        hashed[c] = value;
+    }
+    const std::wstring text = MakeText(charset, length, 42);
+
+    float sink = 0.0f;
+    const double tableMs = TimeMs(text, repeats, [&](wchar_t c) {
+        const GlyphValue* v = table.Find(c);
+        return v ? v->metrics[0] : 0.0f;
+    }, sink);
+    const double mapMs = TimeMs(text, repeats, [&](wchar_t c) {
+        auto it = ordered.find(c);
+        return it != ordered.end() ? it->second.metrics[0] : 0.0f;
+    }, sink);
+    const double hashMs = TimeMs(text, repeats, [&](wchar_t c) {
+        auto it = hashed.find(c);
+        return it != hashed.end() ? it->second.metrics[0] : 0.0f;
+    }, sink);
+
+    const double lookups = static_cast<double>(text.size()) * repeats;
+    std::printf("%-6s (%zu glyphs)\n", name, charset.size());
+    std::printf("  GlyphTable          %8.2f ms  %6.2f ns/lookup\n", tableMs, tableMs * 1e6 / lookups);
+    std::printf("  std::map            %8.2f ms  %6.2f ns/lookup  x%.2f\n", mapMs, mapMs * 1e6 / lookups, mapMs / tableMs);
+    std::printf("  std::unordered_map  %8.2f ms  %6.2f ns/lookup  x%.2f\n", hashMs, hashMs * 1e6 / lookups, hashMs / tableMs);
+    // 防止查找被优化掉
+    if (sink == -1.0f) std::printf("%f\n", sink);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t length = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4096;
+    const int repeats = argc > 2 ? std::atoi(argv[2]) : 2000;
+    if (length == 0 || repeats < 1) {
+        std::fprintf(stderr, "usage: GlyphTableBench [length>=1] [repeats>=1]\n");
+        return 2;
+    }
+    std::printf("text length %zu, repeats %d\n", length, repeats);
+    RunCase("ASCII", AsciiSet(), length, repeats);
+    RunCase("CJK", CjkSet(), length, repeats);
+    RunCase("mixed", MixedSet(), length, repeats);
+    return 0;
+}
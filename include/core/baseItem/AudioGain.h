@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace core {
+
+// 16位PCM的增益与混音内核
+// 增益为Q15定点数：kUnityGain（32768）表示 1.0，0 表示静音，不支持放大。
+// 一次调用内增益从 startGain 线性过渡到 endGain（每 kGainRampBlock 个样本取一个值），
+// 音量变化时用上一块的结束增益作为下一块的起始增益，避免爆音。
+// 运行时按CPU选择 SSE2 / AVX2 / NEON 实现，结果与标量实现逐位一致
+
+constexpr int kUnityGain = 32768;
+constexpr size_t kGainRampBlock = 16;
+
+enum class AudioKernel {
+    Scalar,
+    SSE2,
+    AVX2,
+    NEON,
+};
+
+// 0.0~1.0 的音量转换为Q15增益
+int GainToQ15(float gain);
+
+// samples *= gain，饱和到 int16
+void ApplyGainS16(int16_t* samples, size_t count, int startGain, int endGain);
+// dst += src * gain，饱和到 int16（多路音频混合）
+void MixS16(int16_t* dst, const int16_t* src, size_t count, int startGain, int endGain);
+
+// 当前使用的实现
+AudioKernel GetAudioKernel();
+const char* GetAudioKernelName(AudioKernel kernel);
+// 指定实现（如与标量实现对比）；CPU不支持时返回 false，保持不变
+bool SetAudioKernel(AudioKernel kernel);
+
+} // namespace core
@@ -12,6 +12,8 @@ public:
     Bitmap(const std::string& filePath){Load(filePath);}
     Bitmap(int width, int height, bool createTexture = true, bool useRGB = false); // 创建指定大小的空白位图
     Bitmap(){}
+    // 包装已有纹理，不复制数据（如视频流纹理）
+    explicit Bitmap(std::shared_ptr<Texture> texture);
     ~Bitmap(){ 
         if(rgbData) {
             delete[] rgbData;
@@ -28,13 +30,23 @@ public:
     // 获取纹理ID（用于帧缓冲操作）
     unsigned int GetTextureID() const { return texture ? texture->getTextureID() : 0; }
     
-    void Draw(Region region, float alpha=1.0f);
+    // batched 为 true 时追加到 SpriteBatch，同一纹理（图集页）的位图合并绘制
+    void Draw(Region region, float alpha=1.0f, bool batched=false);
 
-    inline unsigned int getWidth() const { return texture ? texture->getWidth() : m_width; }
-    inline unsigned int getHeight() const { return texture ? texture->getHeight() : m_height; }
+    // 位于共享图集中时，纹理为图集页，UV 为其中的子矩形
+    bool IsInAtlas() const { return m_inAtlas; }
+    const glm::vec4& GetUVRect() const { return m_uvRect; }
+
+    inline unsigned int getWidth() const { return texture && !m_inAtlas ? texture->getWidth() : m_width; }
+    inline unsigned int getHeight() const { return texture && !m_inAtlas ? texture->getHeight() : m_height; }
     inline operator bool() const { return texture != nullptr || rgbData != nullptr; }
 private:
+    // 从解码后的 RGBA 数据创建纹理，小图放入共享图集
+    void CreateTextureFromRGBA(const unsigned char* data, int width, int height);
+
     std::shared_ptr<Texture> texture;
+    glm::vec4 m_uvRect{0.0f, 0.0f, 1.0f, 1.0f};
+    bool m_inAtlas = false;
     unsigned char* rgbData = nullptr; // 存储RGB数据，用于延迟创建纹理
     int m_width = 0;
     int m_height = 0;
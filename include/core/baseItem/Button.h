@@ -75,6 +75,7 @@ public:
     void SetEnable(bool enable) {this->enable = enable;} // Enable/disable button
     bool IsEnable() const {return enable;} // Get enable status
     void SetEnableBitmap(bool enable) {this->enableBitmap = enable;} // Enable/disable bitmap display
+    void SetBatchBitmap(bool enable) {this->batchBitmap = enable;} // Draw bitmap through SpriteBatch (merged per texture)
     void SetEnableFill(bool enable) {this->enableFill = enable;} // Enable/disable background fill
     void SetAspectRatioSnap(bool enable) {enableAspectRatioSnap = enable;} // Enable/disable aspect ratio snapping
     void SetCenterSnap(bool enable) {enableCenterSnap = enable;} // Enable/disable center snapping
@@ -137,6 +138,7 @@ protected:
     bool enableText=true;
     bool enable=true;
     bool enableBitmap=true;
+    bool batchBitmap=false;
     bool enableFill=false;
     bool isCentered=true; // Whether to center the text
     std::string text="";
@@ -222,5 +224,8 @@ private:
     // Button alignment snapping helper methods
     bool ShouldSnapToOtherButtons(const Region& targetRegion, float& snapX, float& snapY) const;
     void ApplyButtonAlignSnap(Region& targetRegion, float snapX, float snapY) const;
+
+    // Mark the window area covered by a region for redraw (on-demand rendering); thread-safe
+    void MarkDirty(const Region& area) const;
 };
 }
\ No newline at end of file
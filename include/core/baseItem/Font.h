@@ -1,13 +1,20 @@
 #pragma once
 
-#include <map>
+#include <deque>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <freetype/freetype.h>
 #include <glm/glm.hpp>
 
 #include "../render/IFontRenderer.h"
 #include "Base.h"
+#include "GlyphCache.h"
+#include "GlyphRasterizer.h"
+#include "GlyphTable.h"
 
 enum FontSize {
     SMALL = 48,
@@ -19,7 +26,7 @@ namespace core
 {
 
 struct Character {
-    unsigned int     TextureID;  // 字符纹理ID
+    IFontRenderer::AtlasSlot Slot; // 字形在图集中的位置（空白字符无效）
     glm::ivec2 Size;             // 字符大小
     glm::ivec2 Bearing;          // 基线到字符左部/顶部的偏移值
     unsigned int     Advance;    // 原点距下一个字形原点的水平偏移量
@@ -34,6 +41,16 @@ public:
     static void SetFontRenderer(IFontRenderer* r) { fontRenderer = r; }
     static IFontRenderer* GetFontRenderer() { return fontRenderer; }
 
+    // 后台光栅化开关（默认开启），关闭时缺失字形在渲染线程同步加载
+    static void SetAsyncRasterization(bool enable) { asyncRasterization = enable; }
+    // 距离场模式下的光栅化像素大小，任意显示大小共用同一套字形
+    static constexpr unsigned int DistanceFieldRasterSize = 64;
+
+    // 每帧上传后台光栅化结果的字节预算
+    static void SetGlyphUploadBudget(size_t bytes) { uploadBudgetBytes = bytes; }
+    // 渲染线程每帧调用：将后台完成的字形按预算放入图集
+    static void ProcessRasterizedGlyphs();
+
     Font(const std::string& fontPath, bool needPreLoad = true, unsigned int fontSize = 48.0f);
     ~Font(); 
     // 渲染文本
@@ -73,18 +90,107 @@ public:
     void RenderStringFitRegion(const std::string& text, SubRegion region, const glm::vec4& color);
 
     unsigned int GetFontSize() const;
+    bool IsDistanceField() const { return distanceField; }
 
     bool operator==(const Font&) const;
     bool isLoaded() const{return isOK;};
 private:
+    // 排版方式，对应各个公开的渲染接口
+    enum class LayoutMode : uint8_t { Line, Vertical, Between, Centered, VerticalBetween, FitRegion };
+
+    // 已定位的字形四边形（以区域左上角为原点）
+    struct LayoutQuad {
+        uint32_t page;
+        uint32_t generation;
+        IFontRenderer::GlyphQuad quad;
+    };
+
+    // 缓存的排版结果，按 (文本, 排版方式, 缩放, 区域大小) 区分
+    struct TextLayout {
+        std::string key;              // 原始文本字节，用于校验哈希冲突
+        bool wide = false;
+        LayoutMode mode = LayoutMode::Line;
+        float scale = 0.0f;
+        float width = 0.0f;
+        float height = 0.0f;
+        uint64_t epoch = 0;           // 排版时的字形版本
+        std::vector<LayoutQuad> quads;
+        std::vector<IFontRenderer::AtlasSlot> pages; // 引用的图集页
+    };
+
+    static std::string_view AsBytes(const std::string& text) { return text; }
+    static std::string_view AsBytes(const std::wstring& text) {
+        return { reinterpret_cast<const char*>(text.data()), text.size() * sizeof(wchar_t) };
+    }
+
     bool LoadCharacter(wchar_t c);
-    Character GetCharacter(wchar_t c);
+    // 修改字符表，并使已缓存的排版失效
+    void StoreCharacter(wchar_t c, const Character& ch);
+    void EraseCharacter(wchar_t c);
+    // 按需打开FreeType字体（缓存全部命中时不需要）
+    bool EnsureFace();
+    // 将光栅化结果放入图集并生成字符信息；图集无法容纳（所有页都被固定）时返回false
+    bool CreateCharacter(const GlyphCache::Entry& glyph, Character& out);
+    const Character& GetCharacter(wchar_t c);
+    // 空白字符（空格等）没有位图，也不占用图集
+    static bool IsBlank(const Character& ch) { return ch.Size.x == 0 || ch.Size.y == 0; }
+    // 获取可直接绘制的字形：按需加载，所在图集页被驱逐时重新光栅化
+    const Character& ResolveGlyph(wchar_t c);
+    // 字形尚未就绪时绘制的占位字形（'?'）
+    const Character& Placeholder();
+    // 请求加载字符：缓存命中或同步加载成功时返回true，交给后台线程时返回false
+    bool RequestCharacter(wchar_t c);
+    // 从备用字体复制字符
+    bool CopyFromSpare(wchar_t c);
+    void OnGlyphRasterized(const GlyphRasterizer::Result& result);
+    // 文字排版：解析字形 -> 设置投影与颜色 -> 追加四边形 -> 按图集页提交
+    void ResolveRun(const std::wstring& text);
+    void BeginTextRun(const glm::vec4& color);
+    static LayoutQuad MakeQuad(const Character& ch, float xpos, float ypos, float w, float h);
+    void AppendQuad(uint32_t page, const IFontRenderer::GlyphQuad& quad);
+    void EndTextRun();
+    // 排版缓存：命中时直接平移并提交四边形，跳过编码转换与字形查找
+    void RenderLayout(std::string_view bytes, bool wide, LayoutMode mode, float x, float y,
+        float width, float height, float scale, const glm::vec4& color);
+    const TextLayout& GetLayout(std::string_view bytes, bool wide, LayoutMode mode, float scale, float width, float height);
+    bool LayoutResident(const TextLayout& layout) const;
+    void BuildLayout(const std::wstring& text, LayoutMode mode, float scale, float width, float height, std::vector<LayoutQuad>& out);
+    void LayoutLine(const std::wstring& text, float x, float y, float scale, std::vector<LayoutQuad>& out);
+    void LayoutVertical(const std::wstring& text, float x, float y, float scale, std::vector<LayoutQuad>& out);
+    void LayoutBetween(const std::wstring& text, float width, float height, float scale, std::vector<LayoutQuad>& out);
+    void LayoutCentered(const std::wstring& text, float width, float height, float scale, std::vector<LayoutQuad>& out);
+    void LayoutVerticalBetween(const std::wstring& text, float width, float height, float scale, std::vector<LayoutQuad>& out);
+    void LayoutFitRegion(const std::wstring& text, float width, float height, std::vector<LayoutQuad>& out);
     float CalculateDynamicScale(float baseScale) const;
     float DeCalculateDynamicScale(float baseScale) const;
 
     bool isOK=false;
-    unsigned int fontSize; // 字体大小
-    std::map<wchar_t, Character> Characters;
+    bool faceFailed=false;
+    unsigned int fontSize; // 光栅化字体大小（距离场模式下为 DistanceFieldRasterSize）
+    unsigned int requestedSize; // 构造时请求的字体大小
+    bool distanceField = false;
+    float sizeFactor = 1.0f; // requestedSize / fontSize，并入动态缩放
+    std::string fontPath;
+    std::unique_ptr<GlyphCache> glyphCache;
+    uint64_t fontId = 0;
+    std::unordered_set<wchar_t> pendingGlyphs;  // 已提交后台光栅化的字符
+    std::unordered_set<wchar_t> missingGlyphs;  // 字体中不存在的字符
+    static bool asyncRasterization;
+    static bool atlasPlacementFailed;  // 本次排版中有字形未能放入图集
+    static size_t uploadBudgetBytes;
+    static uint64_t nextFontId;
+    static std::unordered_map<uint64_t, Font*> registry;
+    static std::deque<std::unique_ptr<GlyphRasterizer::Result>> uploadBacklog;
+    GlyphTable<Character> Characters;
+    // 当前排版中的字形与待提交四边形（复用以避免每次分配）
+    std::vector<Character> runGlyphs;
+    std::vector<IFontRenderer::GlyphQuad> runQuads;
+    uint32_t runPage = IFontRenderer::AtlasSlot::InvalidPage;
+    // 排版缓存；字符表变化或窗口尺寸变化时失效
+    std::unordered_map<uint64_t, TextLayout> layoutCache;
+    uint64_t glyphEpoch = 0;
+    int layoutWindowWidth = -1;
+    int layoutWindowHeight = -1;
     // 渲染器指针（由程序注入）
     static IFontRenderer* fontRenderer;
     // 如果需要的话，添加其他成员变量
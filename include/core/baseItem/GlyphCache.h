@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace core
+{
+
+// 已光栅化字形的磁盘缓存
+// 以字体文件内容哈希、像素大小与位图类型（覆盖率/距离场）区分，启动时内存映射，命中的字形无需经过FreeType。
+// 内容哈希按文件大小与修改时间记录，文件不变时不再读取字体
+class GlyphCache {
+public:
+    struct Entry {
+        int width = 0;
+        int height = 0;
+        int bearingX = 0;
+        int bearingY = 0;
+        unsigned int advance = 0;
+        const unsigned char* bitmap = nullptr; // width*height 字节的单通道位图
+    };
+
+    GlyphCache(const std::string& fontPath, unsigned int pixelSize, bool distanceField = false);
+    ~GlyphCache();
+
+    GlyphCache(const GlyphCache&) = delete;
+    GlyphCache& operator=(const GlyphCache&) = delete;
+
+    // 查找字形，bitmap 指向映射内存，在下一次 Save 之前有效
+    bool Lookup(wchar_t c, Entry& out) const;
+    // 记录新光栅化的字形（复制位图），在 Save 时写入磁盘
+    void Store(wchar_t c, const Entry& entry);
+    // 合并已有与新增的字形并原子地写回磁盘（先写临时文件再重命名）
+    bool Save();
+
+    bool IsValid() const { return fontHash != 0; }
+    size_t GetMappedCount() const { return mappedCount; }
+    const std::string& GetPath() const { return cachePath; }
+
+    // 计算文件内容的 FNV-1a 64 位哈希
+    static uint64_t HashFile(const std::string& path);
+    // 字体文件的内容哈希：按 (路径, 大小, 修改时间) 记录在进程内与磁盘上，
+    // 只有文件变化或首次遇到时才读取整个文件
+    static uint64_t FontHash(const std::string& path);
+
+    static constexpr const char* CacheDirectory = "files/cache/glyphs";
+    // 字体哈希记录文件，每行为 "哈希 大小 修改时间 路径"
+    static constexpr const char* FontIndexFile = "files/cache/glyphs/fonts.idx";
+
+private:
+#pragma pack(push, 1)
+    struct FileHeader {
+        char magic[4];
+        uint32_t version;
+        uint64_t fontHash;
+        uint32_t pixelSize;
+        uint32_t count;
+    };
+    struct IndexEntry {
+        uint32_t codepoint;
+        int16_t width;
+        int16_t height;
+        int16_t bearingX;
+        int16_t bearingY;
+        uint32_t advance;
+        uint32_t offset; // 相对位图数据区起始位置
+    };
+#pragma pack(pop)
+
+    struct PendingGlyph {
+        Entry metrics;
+        std::vector<unsigned char> bitmap;
+    };
+
+    bool Map();
+    void Unmap();
+
+    std::string cachePath;
+    uint64_t fontHash = 0;
+    unsigned int pixelSize = 0;
+
+    // 映射的文件
+    const unsigned char* mapped = nullptr;
+    size_t mappedSize = 0;
+    const IndexEntry* index = nullptr;
+    const unsigned char* blob = nullptr;
+    size_t mappedCount = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+
+    // 本次运行新增、尚未写盘的字形
+    std::map<uint32_t, PendingGlyph> pending;
+};
+
+}
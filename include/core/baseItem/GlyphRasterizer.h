@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "GlyphCache.h"
+
+namespace core
+{
+
+// 后台字形光栅化线程池
+// 每个工作线程拥有独立的 FT_Library 与 FT_Face，结果通过无锁链表交给渲染线程
+class GlyphRasterizer {
+public:
+    struct Request {
+        uint64_t fontId = 0;
+        std::string fontPath;
+        unsigned int pixelSize = 0;
+        wchar_t codepoint = 0;
+        bool distanceField = false; // 输出有向距离场位图
+    };
+
+    // 光栅化结果（侵入式单链表节点）
+    struct Result {
+        Result* next = nullptr;
+        uint64_t fontId = 0;
+        wchar_t codepoint = 0;
+        bool missing = false;   // 字体中没有该字符
+        bool failed = false;    // 字体或字形加载失败
+        GlyphCache::Entry metrics;
+        std::vector<unsigned char> bitmap;
+    };
+
+    static GlyphRasterizer& Get();
+    ~GlyphRasterizer();
+
+    GlyphRasterizer(const GlyphRasterizer&) = delete;
+    GlyphRasterizer& operator=(const GlyphRasterizer&) = delete;
+
+    // 提交光栅化请求（任意线程）
+    void Enqueue(Request request);
+    // 取出所有已完成的结果，按完成顺序排列；调用者负责 delete
+    Result* TakeCompleted();
+
+    size_t GetWorkerCount() const { return workers.size(); }
+
+private:
+    GlyphRasterizer();
+    void WorkerLoop();
+    void PushCompleted(Result* result);
+
+    std::vector<std::thread> workers;
+    std::mutex requestMutex;
+    std::condition_variable requestCv;
+    std::deque<Request> requests;
+    bool stopping = false;
+
+    // 多生产者单消费者的无锁栈，消费者一次性交换取走
+    std::atomic<Result*> completed{nullptr};
+};
+
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace core
+{
+
+// 两级字形表：基本多文种平面(BMP)按256字符分页、只分配用到的页，
+// 其余码点（表情、扩展汉字等）放入线性探测的开放寻址哈希表
+// 注意：哈希表扩容会使指向BMP以外字符的引用失效，调用者不应长期持有引用
+template <typename T>
+class GlyphTable {
+public:
+    T* Find(wchar_t c) {
+        return const_cast<T*>(static_cast<const GlyphTable*>(this)->Find(c));
+    }
+
+    const T* Find(wchar_t c) const {
+        const uint32_t code = static_cast<uint32_t>(c);
+        if (code < kBmpSize) {
+            const Page* page = pages[code >> kPageBits].get();
+            if (!page || !page->used.test(code & kPageMask)) return nullptr;
+            return &page->values[code & kPageMask];
+        }
+        if (slots.empty()) return nullptr;
+        for (size_t i = Hash(code) & (slots.size() - 1);; i = (i + 1) & (slots.size() - 1)) {
+            const Slot& slot = slots[i];
+            if (!slot.used) return nullptr;
+            if (slot.code == code) return &slot.value;
+        }
+    }
+
+    bool Contains(wchar_t c) const { return Find(c) != nullptr; }
+
+    // 插入或覆盖，返回表内元素的引用
+    T& InsertOrAssign(wchar_t c, const T& value) {
+        const uint32_t code = static_cast<uint32_t>(c);
+        if (code < kBmpSize) {
+            auto& page = pages[code >> kPageBits];
+            if (!page) page = std::make_unique<Page>();
+            if (!page->used.test(code & kPageMask)) {
+                page->used.set(code & kPageMask);
+                count++;
+            }
+            return page->values[code & kPageMask] = value;
+        }
+        // 负载因子不超过 1/2
+        if ((extraCount + 1) * 2 > slots.size()) {
+            Rehash(slots.empty() ? 16 : slots.size() * 2);
+        }
+        size_t i = Hash(code) & (slots.size() - 1);
+        while (slots[i].used && slots[i].code != code) {
+            i = (i + 1) & (slots.size() - 1);
+        }
+        if (!slots[i].used) {
+            slots[i].used = true;
+            slots[i].code = code;
+            extraCount++;
+            count++;
+        }
+        return slots[i].value = value;
+    }
+
+    bool Erase(wchar_t c) {
+        const uint32_t code = static_cast<uint32_t>(c);
+        if (code < kBmpSize) {
+            Page* page = pages[code >> kPageBits].get();
+            if (!page || !page->used.test(code & kPageMask)) return false;
+            page->used.reset(code & kPageMask);
+            page->values[code & kPageMask] = T{};
+            count--;
+            return true;
+        }
+        if (slots.empty()) return false;
+        const size_t mask = slots.size() - 1;
+        size_t i = Hash(code) & mask;
+        while (slots[i].used && slots[i].code != code) i = (i + 1) & mask;
+        if (!slots[i].used) return false;
+
+        // 回移删除：把后续同簇元素前移，保持探测链连续，无需墓碑
+        size_t hole = i;
+        for (size_t j = (i + 1) & mask; slots[j].used; j = (j + 1) & mask) {
+            size_t home = Hash(slots[j].code) & mask;
+            // home 不在 (hole, j] 区间内时，该元素可以移入空洞
+            bool between = hole <= j ? (hole < home && home <= j) : (hole < home || home <= j);
+            if (!between) {
+                slots[hole] = std::move(slots[j]);
+                hole = j;
+            }
+        }
+        slots[hole] = Slot{};
+        extraCount--;
+        count--;
+        return true;
+    }
+
+    void Clear() {
+        for (auto& page : pages) page.reset();
+        slots.clear();
+        count = 0;
+        extraCount = 0;
+    }
+
+    size_t Size() const { return count; }
+    bool Empty() const { return count == 0; }
+
+private:
+    static constexpr uint32_t kBmpSize = 0x10000;
+    static constexpr uint32_t kPageBits = 8;
+    static constexpr uint32_t kPageSize = 1u << kPageBits;
+    static constexpr uint32_t kPageMask = kPageSize - 1;
+
+    struct Page {
+        std::array<T, kPageSize> values{};
+        std::bitset<kPageSize> used;
+    };
+
+    struct Slot {
+        uint32_t code = 0;
+        bool used = false;
+        T value{};
+    };
+
+    static size_t Hash(uint32_t code) {
+        // 乘法散列，打散连续码点
+        return static_cast<size_t>((code * 0x9E3779B1u) >> 7);
+    }
+
+    void Rehash(size_t capacity) {
+        std::vector<Slot> old = std::move(slots);
+        slots.assign(capacity, Slot{});
+        for (auto& slot : old) {
+            if (!slot.used) continue;
+            size_t i = Hash(slot.code) & (capacity - 1);
+            while (slots[i].used) i = (i + 1) & (capacity - 1);
+            slots[i] = std::move(slot);
+        }
+    }
+
+    std::array<std::unique_ptr<Page>, kBmpSize / kPageSize> pages;
+    std::vector<Slot> slots;
+    size_t count = 0;
+    size_t extraCount = 0;
+};
+
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace core {
+
+// 有界的单生产者单消费者环形队列
+// 一个线程只调用 Push 系列，另一个线程只调用 Pop 系列；读写索引各自只有一方修改，不需要锁。
+// 队列满或空时用 std::atomic::wait 挂起（Linux 上为 futex），没有等待者时 notify 几乎没有开销
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) : m_slots(capacity > 0 ? capacity : 1) {}
+
+    size_t Capacity() const { return m_slots.size(); }
+    // 另一方可能正在修改，结果只是近似值
+    size_t Size() const {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+    bool Empty() const { return Size() == 0; }
+
+    // 生产者：队列满时返回 false
+    bool TryPush(T value) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) >= m_slots.size()) return false;
+        m_slots[tail % m_slots.size()] = std::move(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        Signal(m_pushed);
+        return true;
+    }
+
+    // 消费者：队列空时返回 false
+    bool TryPop(T& out) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) return false;
+        out = std::move(m_slots[head % m_slots.size()]);
+        m_head.store(head + 1, std::memory_order_release);
+        Signal(m_popped);
+        return true;
+    }
+
+    // 生产者：等待空位写入；stop() 为 true 时放弃并返回 false。
+    // 使 stop() 变为 true 的一方之后必须调用 Wake，否则等待不会结束
+    template <typename Stop>
+    bool WaitPush(T value, Stop stop) {
+        while (true) {
+            const uint32_t seen = m_popped.load(std::memory_order_acquire);
+            if (TryPush(value)) return true;
+            if (stop()) return false;
+            m_popped.wait(seen, std::memory_order_acquire);
+        }
+    }
+
+    // 消费者：等待元素；stop() 为 true 且队列已空时返回 false
+    template <typename Stop>
+    bool WaitPop(T& out, Stop stop) {
+        while (true) {
+            const uint32_t seen = m_pushed.load(std::memory_order_acquire);
+            if (TryPop(out)) return true;
+            // 生产者先写入再改变条件：看到条件改变后再取一次，不会漏掉最后的元素
+            if (stop()) return TryPop(out);
+            m_pushed.wait(seen, std::memory_order_acquire);
+        }
+    }
+
+    // 唤醒两端的等待者，使其重新检查 stop()
+    void Wake() {
+        Signal(m_pushed);
+        Signal(m_popped);
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+private:
+    static void Signal(std::atomic<uint32_t>& event) {
+        event.fetch_add(1, std::memory_order_release);
+        event.notify_all();
+    }
+
+    std::vector<T> m_slots;
+    // 分开放在不同缓存行，避免两个线程互相使对方的缓存失效
+    alignas(64) std::atomic<size_t> m_head{ 0 };      // 只由消费者修改
+    alignas(64) std::atomic<size_t> m_tail{ 0 };      // 只由生产者修改
+    alignas(64) std::atomic<uint32_t> m_pushed{ 0 };  // 每次写入或唤醒时递增
+    alignas(64) std::atomic<uint32_t> m_popped{ 0 };  // 每次取出或唤醒时递增
+};
+
+} // namespace core
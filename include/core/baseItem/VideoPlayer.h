@@ -5,11 +5,13 @@
 #include <mutex>
 #include <thread>
 #include <atomic>
-#include <queue>
 #include <SDL2/SDL.h>
 
+#include "core/baseItem/SpscQueue.h"
+
 struct AVFormatContext;
 struct AVCodecContext;
+struct AVCodec;
 struct AVFrame;
 struct AVPacket;
 struct SwsContext;
@@ -22,6 +24,9 @@ struct AVRational;
 namespace core
 {
 class Bitmap;
+class StreamingTexture;
+struct StreamingTextureStats;
+enum class StreamFormat;
 
 class VideoPlayer
 {   
@@ -29,6 +34,21 @@ class VideoPlayer
     void decodeThreadAudio();
     void decodeThreadVideo();
     std::shared_ptr<FrameData> convertFrameToFrameData(AVFrame* frame);
+    // 创建并打开视频解码器：按配置尝试硬件解码，失败时使用多线程软件解码
+    bool openVideoDecoder(const AVCodec* codec);
+    // 把解码出的帧作为显示时间 pts 的帧排入流纹理，格式或尺寸不符时用 sws_scale 转换。
+    // 帧环已满时等待渲染线程显示旧帧；退出时返回 false
+    bool writeFrameToStream(AVFrame* src, StreamingTexture* stream, double pts);
+    // 渲染线程显示视频帧所用的时钟（秒）
+    double getPresentationClock();
+    // 解复用线程取得空包：优先复用解码线程归还的包
+    AVPacket* acquirePacket();
+    // 解码线程用完的包清空后归还，池满时释放
+    void releasePacket(SpscQueue<AVPacket*>& pool, AVPacket* packet);
+    // 唤醒在包队列上等待的线程（退出或读到文件末尾时）
+    void wakePacketQueues();
+    // 释放队列与包池中所有的包
+    void freeQueuedPackets();
     void applyVolume(uint8_t* audioBuffer, int bufferSize, int channels);
     void cleanup();
     
@@ -56,7 +76,10 @@ public:
 
     void setLoop(bool loop);
     void setVolume(int volume);
+    // 停止播放并释放队列中的数据包
     void cleanBuffer();
+    // 流式视频纹理的上传与丢帧统计；尚未打开视频时为零
+    StreamingTextureStats getFrameStreamStats() const;
     
 private:
     std::atomic<bool> loop{true};
@@ -72,11 +95,25 @@ private:
     std::thread decoderThread;
     std::mutex frameMutex;
     std::shared_ptr<FrameData> currentFrameData = nullptr;
-    std::atomic<bool> frameReady{false};    // SDL音频相关
+    std::atomic<bool> frameReady{false};
+    // 流式视频纹理：每个视频只分配一次，解码线程直接写入其缓冲区
+    std::unique_ptr<StreamingTexture> frameStream;          // 主线程创建与销毁
+    std::atomic<StreamingTexture*> frameStreamPtr{nullptr}; // 解码线程读取
+    std::shared_ptr<Bitmap> frameBitmap;                    // 包装流纹理，getCurrentFrame 返回
+    // 没有音频时的显示时钟：墙钟减去基准，开始、恢复播放或时间轴跳变时重新对齐（主线程）
+    std::chrono::steady_clock::time_point presentClockBase;
+    bool presentClockValid = false;
+    // 解码输出为 YUV420P / NV12 时直接上传各平面，由着色器转换颜色；其他格式用 sws_scale 转为 RGB。
+    // 解码线程在第一帧（frameReady 之前）按实际格式修正，主线程之后才读取
+    StreamFormat streamFormat{};
+    bool colorBt709 = false;
+    bool colorFullRange = false;
+    // SDL音频相关
     SDL_AudioDeviceID audioDeviceID = 0;
     uint8_t* rgbBuffer = nullptr;
     size_t rgbBufferSize = 0;  // Store buffer size for memory tracking
     static std::atomic<float> volume; // 音量范围：0.0-1.0
+    int audioGain = -1;               // 上一块音频结束时的Q15增益，-1 表示还没有处理过（音频线程）
     
     // 音视频同步相关
     std::atomic<double> audioClock{0.0};     // 音频时钟
@@ -96,10 +133,19 @@ private:
     AVStream* videoStream=nullptr;
     SwsContext* swsContext=nullptr;
     SwrContext* swrContext=nullptr;
+    SwsContext* planeSwsContext=nullptr;   // 解码输出与流纹理格式不符时的转换
     AVFrame* frame=nullptr;
     AVFrame* rgbFrame=nullptr;
-    std::queue<AVPacket*> packetVideoQueue;
-    std::queue<AVPacket*> packetAudioQueue;
+    // 硬件解码
+    AVBufferRef* hwDeviceContext=nullptr;
+    int hwPixelFormat=-1;                  // 硬件帧的 AVPixelFormat，-1 表示软件解码
+    AVFrame* hwTransferFrame=nullptr;      // 硬件帧复制到内存后的帧
+    // 解复用线程写入、解码线程读取；队列满时解复用线程阻塞等待
+    SpscQueue<AVPacket*> packetVideoQueue{ 20 };
+    SpscQueue<AVPacket*> packetAudioQueue{ 200 };
+    // 解码线程归还、解复用线程复用的空包
+    SpscQueue<AVPacket*> freeVideoPackets{ 24 };
+    SpscQueue<AVPacket*> freeAudioPackets{ 204 };
 
     // 视频文件相关
     int videoStreamIndex = -1;
@@ -7,13 +7,23 @@
 #define WINDOW_X "window_x"
 #define WINDOW_Y "window_y"
 #define VERTICAL_SYNC "vertical_sync"
+#define TARGET_FPS "target_fps"
+#define MAX_FRAMES_IN_FLIGHT "max_frames_in_flight"
 #define WINDOW_TITLE "window_title"
 
 #define DEBUG "debug"
 #define SHOW_FPS "show_fps"
+#define SHOW_PROFILER "show_profiler"
 #define VOLUME "volume"
 #define LANG "lang"
 #define INWINDOW "inwindow"
+#define GLYPH_CACHE "glyph_cache"
+#define FONT_SDF "font_sdf"
+#define TEXTURE_ATLAS "texture_atlas"
+#define ON_DEMAND_RENDER "on_demand_render"
+#define PARTIAL_REDRAW "partial_redraw"
+#define VIDEO_HWACCEL "video_hwaccel"
+#define VIDEO_DECODE_THREADS "video_decode_threads"
 
 #define UI_REGION_EXIT "ui_region_exit"
 #define UI_REGION_EXIT_EDIT "ui_region_exit_edit"
@@ -22,7 +32,8 @@ enum class boolconfig {
     inwindow=0,
     debug = 1,
     show_fps = 2,
-    vertical_sync = 3
+    vertical_sync = 3,
+    show_profiler = 4
 };
 
 extern std::map<boolconfig, bool> bools;
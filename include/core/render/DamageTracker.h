@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+namespace core {
+
+class Region;
+
+// 本帧的重绘计划
+struct RedrawPlan {
+    bool redraw = true;
+    bool scissor = false;       // 只重绘 scissor 矩形（GL坐标，左下角原点）
+    int x = 0, y = 0, width = 0, height = 0;
+};
+
+// 按需渲染统计（自上次 ResetStats 起）
+struct DamageStats {
+    unsigned int framesRendered = 0;
+    unsigned int framesPartial = 0;  // 其中只重绘了损坏区域的帧
+    unsigned int idleWaits = 0;      // 没有变化而阻塞等待事件的次数
+};
+
+// 按需渲染：屏幕与控件在内容变化时标记脏区域，主循环只在有变化时重绘并交换缓冲区，
+// 否则阻塞在 glfwWaitEventsTimeout 中。Invalidate 可以在任意线程调用（动画线程、解码线程），
+// 会用 glfwPostEmptyEvent 唤醒主循环。
+// 局部重绘（partial_redraw）把损坏区域合并为一个 scissor 矩形；交换后后缓冲区的内容由驱动决定，
+// 这里假设交换链为两个缓冲区轮换，因此同时重绘上一帧的损坏区域
+class DamageTracker {
+public:
+    static DamageTracker& Get();
+
+    // 整个窗口需要重绘
+    void Invalidate();
+    // 窗口像素区域（左上角原点，Region 的 get* 结果）需要重绘
+    void Invalidate(const Region& region);
+    void Invalidate(float x0, float y0, float x1, float y1);
+    // seconds 秒后整窗重绘（如视频下一帧的显示时间）；WaitEvents 最多等到这一时刻。
+    // 多次调用取最早的时间
+    void InvalidateAfter(double seconds);
+
+    void SetOnDemand(bool enable);
+    bool IsOnDemand() const { return m_onDemand; }
+    void SetPartialRedraw(bool enable);
+    bool IsPartialRedraw() const { return m_partial; }
+
+    // 主循环在帧开始时调用；关闭按需渲染时总是整窗重绘
+    RedrawPlan BeginFrame(int framebufferWidth, int framebufferHeight);
+    // 没有需要重绘的内容时调用：等待事件或下一次 Invalidate
+    void WaitEvents();
+
+    const DamageStats& GetStats() const { return m_stats; }
+    void ResetStats() { m_stats = DamageStats(); }
+
+    DamageTracker(const DamageTracker&) = delete;
+    DamageTracker& operator=(const DamageTracker&) = delete;
+
+private:
+    DamageTracker();
+
+    struct Rect {
+        float x0, y0, x1, y1;
+        bool Empty() const { return x1 <= x0 || y1 <= y0; }
+        void Merge(const Rect& other);
+    };
+
+    // 由干净变为脏时唤醒主循环
+    void Wake();
+    // 预定的重绘时间已到时标记整窗重绘
+    void CheckDeadline();
+
+    bool m_onDemand = false;
+    bool m_partial = false;
+    double m_idleTimeout = 0.5;       // 秒，兜底的唤醒间隔
+
+    std::mutex m_mutex;               // 保护 m_full 与 m_damage
+    bool m_full = true;
+    Rect m_damage = { 0, 0, 0, 0 };
+    std::atomic<bool> m_dirty{ true };
+    // 上一帧重绘的区域（局部重绘时合并进本帧）
+    bool m_prevFull = true;
+    Rect m_prevDamage = { 0, 0, 0, 0 };
+    // 预定的重绘时间（m_mutex 保护）
+    bool m_hasDeadline = false;
+    std::chrono::steady_clock::time_point m_deadline;
+    std::atomic<bool> m_waiting{ false }; // 主循环正阻塞在 WaitEvents 中
+    DamageStats m_stats;
+};
+
+} // namespace core
@@ -8,8 +8,17 @@
 #include "core/render/IndexBuffer.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <vector>
 
 namespace core{
+// Drawer每帧的绘制统计
+struct DrawerFrameStats {
+    unsigned int drawCalls = 0;     // glDraw*调用次数
+    unsigned int bufferUploads = 0; // 顶点缓冲上传次数
+    unsigned int vertices = 0;      // 提交的顶点数
+    unsigned int primitives = 0;    // Draw*调用次数（图元数）
+};
+
 class Drawer{
 public:
     Drawer(GLFWwindow* window);
@@ -32,12 +41,48 @@ public:
     // 将屏幕坐标转换为NDC坐标
     glm::vec2 ScreenToNDC(float x, float y) const;
 
+    // 批处理模式（默认开启）：图元先追加到CPU顶点流，帧结束或其他绘制路径介入时统一提交
+    void SetBatchMode(bool enable);
+    bool IsBatchMode() const { return m_batchMode; }
+    // 提交已缓存的图元
+    void Flush();
+    // 帧结束：提交剩余图元并记录本帧统计
+    void EndFrame();
+    // 上一帧的统计
+    const DrawerFrameStats& GetLastFrameStats() const { return m_lastStats; }
+
 private:
+    // 批处理顶点：NDC坐标 + 归一化的RGBA颜色
+    struct BatchVertex {
+        float x, y;
+        unsigned char r, g, b, a;
+    };
+
     GLFWwindow* m_window;
     Shader defaultShader;
+    UniformHandle m_colorUniform;
+    Shader m_batchShader;
+    VertexArray m_batchVa;
+    VertexBuffer m_batchVb;
+    unsigned int m_batchCapacity = 0; // GPU缓冲区容量（字节）
+    std::vector<BatchVertex> m_vertices;
+    bool m_batchMode = true;
+    DrawerFrameStats m_stats;
+    DrawerFrameStats m_lastStats;
 
     // 初始化默认着色器
     void InitDefaultShader();
+    // 初始化批处理着色器与顶点格式
+    void InitBatchResources();
+
+    // 批处理追加（屏幕坐标）
+    void BeginAppend();
+    void PushVertex(glm::vec2 screen, const Color& color);
+    void PushTriangle(glm::vec2 a, glm::vec2 b, glm::vec2 c, const Color& color);
+    void PushQuad(glm::vec2 a, glm::vec2 b, glm::vec2 c, glm::vec2 d, const Color& color);
+    // 以1像素宽的四边形代替GL_LINES
+    void PushLine(glm::vec2 start, glm::vec2 end, const Color& color, bool dashed);
+    static void FlushThunk(void* self) { static_cast<Drawer*>(self)->Flush(); }
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+typedef struct __GLsync* GLsync;
+
+namespace core {
+
+// 帧节奏统计
+struct FramePacerStats {
+    double latencyMs = 0.0;        // 最近一帧的输入到呈现延迟
+    double averageLatencyMs = 0.0; // 指数平均
+    double fenceWaitMs = 0.0;      // 上一帧因在途帧数达到上限而阻塞的时间
+    double limiterSleepMs = 0.0;   // 上一帧帧率限制器等待的时间
+    unsigned int framesInFlight = 0;
+    bool gpuTimestamps = false;    // 延迟由GPU时间戳计算；为 false 时是CPU发现栅栏完成的时刻，只是上界
+};
+
+// 帧节奏控制
+// 代替每帧的 glFinish：交换缓冲区后插入栅栏，CPU最多领先GPU max_frames_in_flight 帧；
+// 关闭垂直同步时按 target_fps 限制帧率（先睡眠，最后一小段自旋以保证精度）。
+// 输入到呈现的延迟以事件处理的时刻到GPU执行完该帧交换的时刻计算：交换后写入 GL_TIMESTAMP 查询，
+// 用 glGetInteger64v(GL_TIMESTAMP) 对齐GPU与CPU时钟。没有计时查询时退化为CPU回收栅栏的时刻，
+// 比实际完成晚最多一帧，应视为上界。两种方式都不包含等待扫描输出的时间
+class FramePacer {
+public:
+    static FramePacer& Get();
+
+    // 设置交换间隔，需要当前GL上下文
+    void SetVSync(bool enable);
+    bool IsVSync() const { return m_vsync; }
+    // 0 表示不限制
+    void SetTargetFps(unsigned int fps) { m_targetFps = fps; }
+    unsigned int GetTargetFps() const { return m_targetFps; }
+    void SetMaxFramesInFlight(unsigned int frames) { m_maxFramesInFlight = frames < 1 ? 1 : frames; }
+
+    // SwapBuffers 之后调用：插入栅栏、限制在途帧数并执行帧率限制
+    void EndFrame();
+    // 处理完窗口事件后调用，记录本帧输入的采样时刻
+    void OnInputPolled();
+
+    const FramePacerStats& GetStats() const { return m_stats; }
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+private:
+    FramePacer();
+
+    using Clock = std::chrono::steady_clock;
+
+    struct InFlight {
+        GLsync fence;
+        Clock::time_point input; // 该帧使用的输入的采样时刻
+        unsigned int query;      // 交换后的时间戳查询，0 表示没有
+    };
+
+    // 回收已完成的栅栏；wait 为 true 时阻塞等待最早的一个
+    void Retire(bool wait);
+    void OnPresented(const InFlight& frame, Clock::time_point now);
+    void LimitFrameRate();
+    // 交换后写入时间戳查询，必要时重新对齐GPU时钟；不可用时返回 0
+    unsigned int IssueTimestamp();
+    // 把GPU时间戳换算为CPU时钟
+    Clock::time_point GpuToCpu(uint64_t gpuNs) const;
+
+    bool m_vsync = true;
+    unsigned int m_targetFps = 0;
+    unsigned int m_maxFramesInFlight = 2;
+    std::deque<InFlight> m_inFlight;
+    Clock::time_point m_lastInput;
+    Clock::time_point m_nextDeadline;
+    FramePacerStats m_stats;
+    bool m_timestampChecked = false;
+    std::vector<unsigned int> m_freeQueries;
+    int64_t m_gpuClockOffsetNs = 0;     // GPU时间戳减去CPU时钟
+    Clock::time_point m_lastCalibration;
+};
+
+} // namespace core
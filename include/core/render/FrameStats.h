@@ -0,0 +1,31 @@
+#pragma once
+
+namespace core {
+
+// 每帧的绘制统计
+struct FrameDrawStats {
+    unsigned int drawCalls = 0;      // 本帧 glDraw* 调用总数
+    unsigned int primitiveDraws = 0; // Drawer 图元
+    unsigned int spriteDraws = 0;    // SpriteBatch 精灵
+    unsigned int textDraws = 0;      // 文字（批处理或逐字）
+    unsigned int textureDraws = 0;   // 即时绘制的 Texture::Draw
+};
+
+// 帧结束：提交各批处理器中剩余的数据，并汇总本帧各绘制路径的 glDraw* 次数
+class FrameStats {
+public:
+    static FrameStats& Get();
+
+    void EndFrame();
+    const FrameDrawStats& GetLastFrame() const { return m_last; }
+
+    FrameStats(const FrameStats&) = delete;
+    FrameStats& operator=(const FrameStats&) = delete;
+
+private:
+    FrameStats() = default;
+
+    FrameDrawStats m_last;
+};
+
+} // namespace core
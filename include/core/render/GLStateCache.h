@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+
+namespace core {
+
+// GL状态调用统计
+struct GLStateStats {
+    unsigned long long issued = 0;  // 实际发出的状态调用
+    unsigned long long elided = 0;  // 与当前状态相同而跳过的调用
+};
+
+// OpenGL 绑定与固定功能状态的影子副本：与当前状态相同的调用直接跳过。
+// 引擎内的绑定都应经过这里；外部代码直接修改了GL状态时需要调用 Invalidate()
+class GLStateCache {
+public:
+    static GLStateCache& Get();
+
+    void UseProgram(unsigned int program);
+    void BindVertexArray(unsigned int vao);
+    // 缓存 GL_ARRAY_BUFFER；GL_ELEMENT_ARRAY_BUFFER 属于VAO状态，其他目标不缓存，直接转发
+    void BindBuffer(unsigned int target, unsigned int buffer);
+    void ActiveTexture(unsigned int unit); // unit 为下标（0 表示 GL_TEXTURE0）
+    // 绑定到当前纹理单元（仅缓存 GL_TEXTURE_2D）
+    void BindTexture(unsigned int target, unsigned int texture);
+    void BindTexture(unsigned int unit, unsigned int target, unsigned int texture);
+    void SetBlend(bool enable);
+    void BlendFunc(unsigned int src, unsigned int dst);
+    void Viewport(int x, int y, int width, int height);
+
+    // 对象删除后调用：GL会自动解除其绑定，对应的缓存项需要同步
+    void OnProgramDeleted(unsigned int program);
+    void OnVertexArrayDeleted(unsigned int vao);
+    void OnBufferDeleted(unsigned int buffer);
+    void OnTextureDeleted(unsigned int texture);
+
+    // 忘记全部缓存状态，下一次调用一定会发给GL
+    void Invalidate();
+
+    unsigned int GetProgram() const { return m_program; }
+    unsigned int GetVertexArray() const { return m_vao; }
+
+    const GLStateStats& GetStats() const { return m_stats; }
+    void ResetStats() { m_stats = GLStateStats(); }
+
+    GLStateCache(const GLStateCache&) = delete;
+    GLStateCache& operator=(const GLStateCache&) = delete;
+
+private:
+    GLStateCache();
+
+    static constexpr unsigned int Unknown = 0xFFFFFFFFu;
+    static constexpr unsigned int MaxTextureUnits = 16;
+
+    // 状态相同返回false并计数；不同则更新缓存并返回true
+    bool Change(unsigned int& cached, unsigned int value);
+
+    unsigned int m_program = Unknown;
+    unsigned int m_vao = Unknown;
+    unsigned int m_arrayBuffer = Unknown;
+    unsigned int m_activeUnit = Unknown;
+    std::array<unsigned int, MaxTextureUnits> m_textures;
+    unsigned int m_blend = Unknown;
+    unsigned int m_blendSrc = Unknown;
+    unsigned int m_blendDst = Unknown;
+    std::array<int, 4> m_viewport;
+    bool m_viewportKnown = false;
+    GLStateStats m_stats;
+};
+
+} // namespace core
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace core {
+
+// 字形图集的CPU端管理：货架（shelf）装箱、多页、按页LRU驱逐
+// 只负责分配矩形区域，纹理的创建与上传由渲染后端完成
+class GlyphAtlas {
+public:
+    struct Allocation {
+        uint32_t page = 0;        // 页号
+        uint32_t generation = 0;  // 页的代数，页被驱逐后递增
+        int x = 0;                // 字形像素区域左上角（已去除边距）
+        int y = 0;
+        bool newPage = false;     // 本次分配新建了一页，后端需要创建纹理
+    };
+
+    GlyphAtlas(int pageSize = 2048, uint32_t maxPages = 16, int padding = 1);
+
+    // 分配 width x height 的区域，空间不足时新建页或驱逐最久未使用的页
+    bool Allocate(int width, int height, Allocation& out);
+    // 槽位所在页是否仍然有效（未被驱逐）
+    bool IsResident(uint32_t page, uint32_t generation) const;
+    // 记录一次使用，用于LRU
+    void Touch(uint32_t page);
+    // 固定期间使用过的页不会被驱逐，保证一段文字排版时已解析的字形仍然有效；可嵌套。
+    // 所有页都被固定时分配失败
+    void BeginPin();
+    void EndPin();
+    // 清空全部页
+    void Clear();
+
+    // 驱逐某页之前的回调（例如提交仍引用该页的待绘制数据）
+    void SetEvictCallback(std::function<void(uint32_t page)> callback) { onEvict = std::move(callback); }
+
+    int GetPageSize() const { return pageSize; }
+    int GetPadding() const { return padding; }
+    size_t GetPageCount() const { return pages.size(); }
+    uint64_t GetEvictionCount() const { return evictions; }
+
+private:
+    struct Shelf {
+        int y = 0;
+        int height = 0;
+        int cursorX = 0;
+    };
+    struct Page {
+        std::vector<Shelf> shelves;
+        int nextY = 0;
+        uint32_t generation = 0;
+        uint64_t lastUse = 0;
+    };
+
+    bool AllocateInPage(Page& page, int width, int height, int& x, int& y);
+    void ResetPage(Page& page);
+
+    int pageSize;
+    uint32_t maxPages;
+    int padding;
+    std::vector<Page> pages;
+    uint64_t clock = 0;
+    uint64_t evictions = 0;
+    uint32_t pinDepth = 0;
+    uint64_t pinClock = 0;    // 固定期间 lastUse 不小于此值的页被固定
+    std::function<void(uint32_t page)> onEvict;
+};
+
+} // namespace core
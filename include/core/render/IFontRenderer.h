@@ -1,6 +1,7 @@
 #pragma once
 #include <cstdint>
 #include <cstddef>
+#include <span>
 #include <glm/glm.hpp>
 
 namespace core {
@@ -9,6 +10,24 @@ class IFontRenderer {
 public:
     using TextureId = uint64_t;
 
+    // 字形在图集中的位置
+    struct AtlasSlot {
+        static constexpr uint32_t InvalidPage = 0xFFFFFFFFu;
+        uint32_t page = InvalidPage; // 图集页号
+        uint32_t generation = 0;     // 分配时的页代数，用于判断是否已被驱逐
+        glm::vec4 uv{0.0f};          // u0, v0（字形顶部）, u1, v1（字形底部）
+
+        bool IsValid() const { return page != InvalidPage; }
+    };
+
+    // 一个字形四边形（与 SetProjection 同一坐标系，y 轴向上）
+    struct GlyphQuad {
+        float x0, y0;  // 左下角
+        float x1, y1;  // 右上角
+        float u0, v0;  // 字形顶部纹理坐标
+        float u1, v1;  // 字形底部纹理坐标
+    };
+
     virtual ~IFontRenderer() = default;
 
     // 在窗口创建并有上下文后调用（OpenGL 需要 context，Vulkan 可能需要 surface 等）
@@ -21,6 +40,19 @@ public:
     // 删除纹理
     virtual void DeleteTexture(TextureId id) = 0;
 
+    // 将单通道字形位图放入图集，空间不足时由后端按LRU驱逐整页
+    virtual bool AllocateGlyph(int width, int height, const unsigned char* data, AtlasSlot& outSlot) = 0;
+
+    // 检查字形是否仍在图集中，若在则刷新其所在页的LRU记录
+    virtual bool TouchGlyph(const AtlasSlot& slot) = 0;
+
+    // 固定/解除固定之间使用过的图集页，期间分配新字形不会驱逐它们（可嵌套）
+    virtual void BeginAtlasPin() {}
+    virtual void EndAtlasPin() {}
+
+    // 获取图集页对应的纹理
+    virtual TextureId GetAtlasTexture(uint32_t page) const = 0;
+
     // 绑定纹理（后端实现）
     virtual void BindTexture(TextureId id) = 0;
 
@@ -30,6 +62,9 @@ public:
     // 设置文字颜色与 alphaMultiplier
     virtual void SetTextColor(const glm::vec3& color, float alphaMultiplier) = 0;
 
+    // 设置之后提交的字形是否为有向距离场位图（0.5 为边缘），否则为覆盖率位图
+    virtual void SetDistanceField(bool enable) = 0;
+
     // 在渲染文本前调用（例如启用混合、绑定 shader）
     virtual void PrepareForText() = 0;
 
@@ -39,6 +74,32 @@ public:
     // 绘制当前顶点缓冲区（按顶点数）
     virtual void DrawTriangles(int vertexCount) = 0;
 
+    // 提交一段位于同一图集页的字形，使用当前的投影与颜色。
+    // 批处理后端可将整帧的文字合并为每页一次绘制；默认实现逐字形上传并绘制（回退路径）
+    virtual void SubmitQuads(std::span<const GlyphQuad> quads, uint32_t atlasPage) {
+        if (quads.empty()) return;
+        BindTexture(GetAtlasTexture(atlasPage));
+        for (const GlyphQuad& q : quads) {
+            float vertices[6][4] = {
+                { q.x0, q.y1, q.u0, q.v0 },
+                { q.x0, q.y0, q.u0, q.v1 },
+                { q.x1, q.y0, q.u1, q.v1 },
+
+                { q.x0, q.y1, q.u0, q.v0 },
+                { q.x1, q.y0, q.u1, q.v1 },
+                { q.x1, q.y1, q.u1, q.v0 }
+            };
+            UpdateVertexBuffer(vertices, sizeof(vertices));
+            DrawTriangles(6);
+        }
+    }
+
+    // 提交所有缓存的文字（批处理后端在帧结束前调用，默认无操作）
+    virtual void FlushText() {}
+
+    // 自上次调用以来的 glDraw* 次数，返回后清零（用于帧统计）
+    virtual unsigned int TakeDrawCalls() { return 0; }
+
     // 关闭并释放后端资源
     virtual void Shutdown() = 0;
 };
@@ -0,0 +1,30 @@
+#pragma once
+
+namespace core {
+
+// 空渲染后端的计数
+struct NullBackendStats {
+    unsigned long long drawCalls = 0;          // glDraw* 调用次数
+    unsigned long long vertices = 0;           // 绘制的顶点/索引数
+    unsigned long long stateChanges = 0;       // 绑定、启用/禁用、混合、视口等状态调用
+    unsigned long long uniformUploads = 0;     // glUniform* 调用次数
+    unsigned long long bufferUploads = 0;      // 缓冲区数据上传次数（BufferData/SubData/映射写入）
+    unsigned long long bufferUploadBytes = 0;
+    unsigned long long textureUploads = 0;     // 纹理数据上传次数（TexImage/TexSubImage）
+    unsigned long long textureUploadBytes = 0;
+    unsigned long long objectsCreated = 0;     // 创建的缓冲、纹理、着色器、程序等对象
+};
+
+// 空渲染后端：没有GL上下文时，把 glad 的函数指针指向只做计数的桩函数。
+// 绘制代码无需修改即可在无GPU的机器上运行（基准测试、回归测试），
+// 结果只反映提交给驱动的调用，不产生任何像素
+class NullBackend {
+public:
+    // 代替 gladLoadGLLoader 调用；之后 Renderer 后端为 Backend::Null
+    static bool Initialize();
+
+    static const NullBackendStats& GetStats();
+    static void ResetStats();
+};
+
+} // namespace core
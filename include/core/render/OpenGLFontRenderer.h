@@ -1,8 +1,10 @@
 #pragma once
 #include "core/render/IFontRenderer.h"
+#include "core/render/GlyphAtlas.h"
 #include "core/render/Shader.h"
 #include <GLFW/glfw3.h>
 #include <memory>
+#include <vector>
 
 namespace core {
 
@@ -14,15 +16,42 @@ public:
     bool Initialize(void* windowHandle) override;
     TextureId CreateGlyphTexture(int width, int height, const unsigned char* data) override;
     void DeleteTexture(TextureId id) override;
+    bool AllocateGlyph(int width, int height, const unsigned char* data, AtlasSlot& outSlot) override;
+    bool TouchGlyph(const AtlasSlot& slot) override;
+    void BeginAtlasPin() override;
+    void EndAtlasPin() override;
+    TextureId GetAtlasTexture(uint32_t page) const override;
     void BindTexture(TextureId id) override;
     void SetProjection(const glm::mat4& projection) override;
     void SetTextColor(const glm::vec3& color, float alphaMultiplier) override;
+    void SetDistanceField(bool enable) override;
     void PrepareForText() override;
     void UpdateVertexBuffer(const void* data, size_t size) override;
     void DrawTriangles(int vertexCount) override;
+    void SubmitQuads(std::span<const GlyphQuad> quads, uint32_t atlasPage) override;
+    void FlushText() override;
+    unsigned int TakeDrawCalls() override;
     void Shutdown() override;
 
+    // 批处理开关：关闭时回退到逐字形绘制
+    void SetBatching(bool enable);
+    bool IsBatching() const { return m_batching; }
+
 private:
+    // 批处理顶点：屏幕坐标、纹理坐标、颜色与位图类型
+    struct TextVertex {
+        float x, y, u, v;
+        unsigned char r, g, b, a;
+        float distanceField;
+    };
+    struct PageRange {
+        uint32_t page;
+        int first;
+        int count;
+    };
+
+    static void FlushThunk(void* self) { static_cast<OpenGLFontRenderer*>(self)->FlushText(); }
+
     GLFWwindow* m_window = nullptr;
     unsigned int m_vao = 0;
     unsigned int m_vbo = 0;
@@ -31,7 +60,26 @@ private:
     glm::mat4 m_projection;
     glm::vec3 m_textColor;
     float m_alpha = 1.0f;
+    bool m_distanceField = false;
     bool m_initialized = false;
+    bool m_projectionSet = false;
+    unsigned int m_drawCalls = 0;
+
+    // 文字批处理：按图集页分桶，刷新时写入同一个映射缓冲，每页绘制一次
+    bool m_batching = true;
+    core::Shader m_batchShader;
+    unsigned int m_batchVao = 0;
+    unsigned int m_batchVbo = 0;
+    size_t m_batchCapacity = 0;
+    std::vector<std::vector<TextVertex>> m_pageVertices;
+    std::vector<PageRange> m_pageRanges;
+    size_t m_pendingVertices = 0;
+
+    // 字形图集（所有字体共享）
+    GlyphAtlas m_atlas;
+    std::vector<unsigned int> m_atlasTextures;
+    // 上传字形时使用的临时缓冲（包含边距）
+    std::vector<unsigned char> m_uploadScratch;
 };
 
 } // namespace core
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace core {
+
+class Font;
+
+// 区域在最近若干帧中的平均耗时
+struct ProfileZoneSummary {
+    const char* name = nullptr;
+    double cpuMs = 0.0;       // 每帧平均CPU耗时（同名区域累加）
+    double gpuMs = -1.0;      // 每帧平均GPU耗时，没有计时查询结果时为负
+    double callsPerFrame = 0.0;
+};
+
+// 帧时间分析器
+// 用 PROFILE_SCOPE 标记的区域记录CPU耗时，最外层区域在支持 GL_TIME_ELAPSED 时同时记录GPU耗时
+// （计时查询不能嵌套，结果在若干帧后回读）。最近 FrameHistory 帧保存在环形缓冲区中，
+// 可以绘制为屏幕叠加层或导出为 Chrome trace JSON（chrome://tracing、Perfetto）
+class Profiler {
+public:
+    static constexpr size_t FrameHistory = 300;
+    static constexpr size_t MaxZonesPerFrame = 4096;
+
+    static Profiler& Get();
+
+    // 帧边界，由主循环调用
+    void BeginFrame();
+    void EndFrame();
+
+    // name 必须是静态字符串（记录时只保存指针）
+    void BeginZone(const char* name);
+    void EndZone();
+
+    void SetEnabled(bool enable) { m_enabled = enable; }
+    bool IsEnabled() const { return m_enabled; }
+    // GPU计时会在每个最外层区域前后插入查询，只在需要时开启
+    void SetGpuTiming(bool enable) { m_gpuRequested = enable; }
+    bool IsGpuTimingAvailable() const { return m_gpuAvailable; }
+
+    // 最近帧的帧时间百分位（毫秒），p 取 0~100
+    double GetFrameTimePercentile(double p) const;
+    // 最近帧中平均CPU耗时最大的 count 个区域
+    std::vector<ProfileZoneSummary> GetTopZones(size_t count) const;
+
+    // 在右上角绘制百分位与耗时最多的区域
+    void DrawOverlay(Font& font);
+    // 导出环形缓冲区中的全部帧
+    bool ExportChromeTrace(const std::string& path) const;
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+private:
+    Profiler();
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Zone {
+        const char* name;
+        int64_t startUs;  // 相对 m_epoch
+        int64_t durUs;
+        int64_t gpuNs;    // 负数表示没有GPU结果
+        uint32_t depth;
+    };
+    struct Frame {
+        uint64_t index = 0;   // 0 表示空槽
+        int64_t startUs = 0;
+        int64_t durUs = 0;
+        std::vector<Zone> zones;
+    };
+    struct PendingQuery {
+        unsigned int query;
+        uint64_t frameIndex;
+        uint32_t zone;
+    };
+
+    int64_t NowUs() const;
+    Frame& Slot(uint64_t frameIndex) { return m_frames[frameIndex % FrameHistory]; }
+    const Frame* FindFrame(uint64_t frameIndex) const;
+    void DetectGpuTiming();
+    // 回读已完成的计时查询
+    void CollectQueries();
+
+    bool m_enabled = true;
+    bool m_inFrame = false;
+    Clock::time_point m_epoch;
+    uint64_t m_frameIndex = 0;
+    std::array<Frame, FrameHistory> m_frames;
+    std::vector<uint32_t> m_stack;  // 当前帧中未结束的区域
+    uint32_t m_dropped = 0;         // 帧外或超出 MaxZonesPerFrame 而未记录的区域
+
+    bool m_gpuRequested = false;
+    bool m_gpuChecked = false;
+    bool m_gpuAvailable = false;
+    int m_gpuZoneDepth = -1;        // 持有计时查询的区域深度
+    std::vector<unsigned int> m_freeQueries;
+    std::vector<PendingQuery> m_pendingQueries;
+};
+
+// RAII 区域
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) { Profiler::Get().BeginZone(name); }
+    ~ProfileScope() { Profiler::Get().EndZone(); }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+} // namespace core
+
+#define PW_PROFILE_CONCAT_INNER(a, b) a##b
+#define PW_PROFILE_CONCAT(a, b) PW_PROFILE_CONCAT_INNER(a, b)
+// 记录到当前作用域结束
+#define PROFILE_SCOPE(name) ::core::ProfileScope PW_PROFILE_CONCAT(profileScope_, __LINE__)(name)
@@ -13,6 +13,9 @@ public:
     void Viewport(int x, int y, int width, int height);
     void ClearColor(float r, float g, float b, float a);
     void Clear(unsigned int mask);
+    // 之后的清除与绘制只影响该矩形（GL坐标，左下角原点）
+    void SetScissor(int x, int y, int width, int height);
+    void DisableScissor();
 
 private:
     RenderAPI();
@@ -6,7 +6,8 @@ namespace core {
 
 class Renderer {
 public:
-    enum class Backend { OpenGL, Vulkan, Unknown };
+    // Null：没有GL上下文，GL入口指向只计数的桩函数（见 NullBackend）
+    enum class Backend { OpenGL, Vulkan, Null, Unknown };
 
     static Renderer& Get();
 
@@ -18,9 +19,21 @@ public:
     // Execute callable; when OpenGL backend is active, the GL error helpers will be used.
     void CallWithError(const std::function<void()>& fn, const char* exprStr, const char* file, int line) const;
 
+    // 批处理协调：同一时刻只有一个批处理器持有未提交的数据。
+    // 批处理器追加数据前调用 SetActiveBatcher，即时绘制路径绘制前调用 FlushActiveBatcher，
+    // 以保证跨批处理器的绘制顺序与提交顺序一致。
+    using BatchFlushFn = void(*)(void* owner);
+    void SetActiveBatcher(void* owner, BatchFlushFn flush);
+    // 刷新当前持有数据的批处理器（如果有）
+    void FlushActiveBatcher() { SetActiveBatcher(nullptr, nullptr); }
+    // 批处理器自行刷新后调用，放弃活动状态
+    void ReleaseBatcher(void* owner);
+
 private:
     Renderer();
     Backend m_backend = Backend::Unknown;
+    void* m_activeBatcher = nullptr;
+    BatchFlushFn m_activeFlush = nullptr;
 };
 
 } // namespace core
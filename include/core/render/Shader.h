@@ -1,7 +1,10 @@
 #pragma once
 #include "GLBase.h"
+#include "ShaderProgramCache.h"
 #include <glad/glad.h>
 #include <string>
+#include <string_view>
+#include <vector>
 #include <glm/glm.hpp>
 
 // Forward declaration to avoid circular dependency
@@ -12,12 +15,31 @@ namespace core {
 
 namespace core {
 
+// uniform句柄：着色器uniform表中的下标
+struct UniformHandle {
+    int index = -1;
+    explicit operator bool() const { return index >= 0; }
+};
+
+// uniform调用统计
+struct UniformStats {
+    unsigned long long lookupsAvoided = 0; // 省去的 glGetUniformLocation 调用
+    unsigned long long callsElided = 0;    // 值未变化而跳过的 glUniform* 调用
+    unsigned long long callsIssued = 0;    // 实际发出的 glUniform* 调用
+};
+
 class Shader {
     unsigned int ID=0;
-    std::string VertexShader="";
-	std::string fragmentShader="";
+    // 共享的已链接程序（由 ShaderProgramCache 引用计数），副本只是句柄
+    ShaderProgram* program=nullptr;
+    static UniformStats stats;
+
+    void Release();
+    int Location(std::string_view name) const;
+    // 与缓存的值比较，不同则更新缓存并返回true
+    bool UpdateValue(UniformHandle handle, const void* data, size_t bytes) const;
 public:
-    // 构造函数读取并编译着色器
+    // 构造函数获取（相同源码共享，必要时编译）着色器程序
     Shader(const std::string& VertexShader, const std::string& fragmentShader);
 	Shader(const Shader&);
     Shader();
@@ -29,43 +51,58 @@ public:
     void use() const;
     void Bind() const{use();};
 
-    // 设置uniform变量
-    void setInt(const std::string& name, int value) const{GLCall(glUniform1i(glGetUniformLocation(ID, name.c_str()), value));}
-    void setFloat(const std::string& name, float value) const{GLCall(glUniform1f(glGetUniformLocation(ID, name.c_str()), value));}
-    void set2float(const std::string& name, float value1, float value2) const{GLCall(glUniform2f(glGetUniformLocation(ID, name.c_str()), value1, value2));}
-    void setVec3(const std::string& name, const glm::vec3& value) const{GLCall(glUniform3f(glGetUniformLocation(ID, name.c_str()), value.x, value.y, value.z));}
-    void setVec4(const std::string& name, const glm::vec4& value) const{GLCall(glUniform4f(glGetUniformLocation(ID, name.c_str()), value.x, value.y, value.z, value.w));}
-    void setMat4(const std::string& name, const glm::mat4& mat) const{GLCall(glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]));}
+    // 设置uniform变量（按名称，在链接后建立的表中查找，不调用glGetUniformLocation）
+    void setInt(std::string_view name, int value) const{setInt(GetUniform(name), value);}
+    void setFloat(std::string_view name, float value) const{setFloat(GetUniform(name), value);}
+    void set2float(std::string_view name, float value1, float value2) const{set2float(GetUniform(name), value1, value2);}
+    void setVec3(std::string_view name, const glm::vec3& value) const{setVec3(GetUniform(name), value);}
+    void setVec4(std::string_view name, const glm::vec4& value) const{setVec4(GetUniform(name), value);}
+    void setMat4(std::string_view name, const glm::mat4& mat) const{setMat4(GetUniform(name), mat);}
+
+    // 设置uniform变量（按句柄）：值未变化时不调用GL
+    void setInt(UniformHandle handle, int value) const;
+    void setFloat(UniformHandle handle, float value) const;
+    void set2float(UniformHandle handle, float value1, float value2) const;
+    void setVec3(UniformHandle handle, const glm::vec3& value) const;
+    void setVec4(UniformHandle handle, const glm::vec4& value) const;
+    void setMat4(UniformHandle handle, const glm::mat4& mat) const;
+
+    // 获取uniform句柄，可长期保存；重新 init 后需要重新获取
+    UniformHandle GetUniform(std::string_view name) const;
+
+    // 全部着色器的uniform统计
+    static const UniformStats& GetUniformStats() { return stats; }
+    static void ResetUniformStats() { stats = UniformStats(); }
 
     //获取uniform变量
-	int getInt(const std::string& name) const{
+	int getInt(std::string_view name) const{
         int value;
-        GLCall(glGetUniformiv(ID, glGetUniformLocation(ID, name.c_str()), &value));
+        GLCall(glGetUniformiv(ID, Location(name), &value));
         return value;
     }
-	unsigned int getUInt(const std::string& name) const{
+	unsigned int getUInt(std::string_view name) const{
         unsigned int value;
-        GLCall(glGetUniformuiv(ID, glGetUniformLocation(ID, name.c_str()), &value));
+        GLCall(glGetUniformuiv(ID, Location(name), &value));
         return value;
     }
-	float getFloat(const std::string& name) const{
+	float getFloat(std::string_view name) const{
         float value;
-        GLCall(glGetUniformfv(ID, glGetUniformLocation(ID, name.c_str()), &value));
+        GLCall(glGetUniformfv(ID, Location(name), &value));
         return value;
     }
-	glm::vec3 getVec3(const std::string& name) const{
+	glm::vec3 getVec3(std::string_view name) const{
         glm::vec3 value;
-        GLCall(glGetUniformfv(ID, glGetUniformLocation(ID, name.c_str()), &value[0]));
+        GLCall(glGetUniformfv(ID, Location(name), &value[0]));
         return value;
     }
-	glm::vec4 getVec4(const std::string& name) const{
+	glm::vec4 getVec4(std::string_view name) const{
         glm::vec4 value;
-        GLCall(glGetUniformfv(ID, glGetUniformLocation(ID, name.c_str()), &value[0]));
+        GLCall(glGetUniformfv(ID, Location(name), &value[0]));
         return value;
     }
-	glm::mat4 getMat4(const std::string& name) const{
+	glm::mat4 getMat4(std::string_view name) const{
         glm::mat4 value;
-        GLCall(glGetUniformfv(ID, glGetUniformLocation(ID, name.c_str()), &value[0][0]));
+        GLCall(glGetUniformfv(ID, Location(name), &value[0][0]));
         return value;
     }
 	// 重载赋值运算符
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace core {
+
+// 链接后解析的活动uniform，保存位置与最近一次设置的值
+struct ShaderUniform {
+    std::string name;
+    int location = -1;
+    bool hasValue = false;
+    float value[16] = {};
+};
+
+// 共享的已链接程序：uniform值属于程序状态，因此值缓存也随程序共享
+struct ShaderProgram {
+    unsigned int id = 0;
+    unsigned int refs = 0;
+    std::string key;
+    std::vector<ShaderUniform> uniforms;
+};
+
+// 着色器程序缓存
+// 相同的(顶点, 片段)源码共享同一个链接好的程序（引用计数）；
+// 链接结果通过 glGetProgramBinary 保存到磁盘，以驱动字符串和源码哈希区分，再次启动时跳过编译与链接
+class ShaderProgramCache {
+public:
+    static ShaderProgramCache& Get();
+
+    // 获取（必要时编译或从磁盘加载）程序并增加引用，失败返回nullptr
+    ShaderProgram* Acquire(const std::string& vertexSource, const std::string& fragmentSource);
+    void AddRef(ShaderProgram* program);
+    // 减少引用，归零时删除程序
+    void Release(ShaderProgram* program);
+
+    size_t GetProgramCount() const { return programs.size(); }
+
+    static constexpr const char* CacheDirectory = "files/cache/shaders";
+
+    ShaderProgramCache(const ShaderProgramCache&) = delete;
+    ShaderProgramCache& operator=(const ShaderProgramCache&) = delete;
+
+private:
+    ShaderProgramCache() = default;
+
+#pragma pack(push, 1)
+    struct FileHeader {
+        char magic[4];
+        uint32_t version;
+        uint64_t sourceHash;
+        uint32_t format;
+        uint32_t length;
+    };
+#pragma pack(pop)
+
+    // 首次使用时查询驱动是否支持程序二进制
+    void InitBinarySupport();
+    std::string BinaryPath(uint64_t hash) const;
+    unsigned int LoadBinary(uint64_t hash);
+    void SaveBinary(unsigned int program, uint64_t hash);
+    unsigned int CompileAndLink(const std::string& vertexSource, const std::string& fragmentSource);
+    static void LoadUniforms(ShaderProgram& program);
+
+    std::unordered_map<std::string, std::unique_ptr<ShaderProgram>> programs;
+    bool binaryChecked = false;
+    bool binarySupported = false;
+    std::string driver; // GL_VENDOR / GL_RENDERER / GL_VERSION
+};
+
+} // namespace core
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "core/render/Shader.h"
+#include "core/render/Texture.h"
+#include "core/render/VertexArray.h"
+#include "core/render/VertexBuffer.h"
+
+namespace core {
+
+// SpriteBatch每帧的绘制统计
+struct SpriteBatchStats {
+    unsigned int sprites = 0;       // 提交的四边形数
+    unsigned int drawCalls = 0;     // glDraw*调用次数
+    unsigned int bufferUploads = 0; // 顶点缓冲上传次数
+};
+
+// 纹理四边形批处理：顶点在CPU端变换后写入同一个流式顶点缓冲，
+// 刷新时相同纹理的连续四边形合并为一次绘制
+class SpriteBatch {
+public:
+    static SpriteBatch& Get();
+
+    /* 追加一个纹理四边形（参数与 Texture::Draw 相同，坐标为NDC）
+    * @param uvRect 采样的子矩形 (u0, v0, u1, v1)，v0 为图像顶部
+    * */
+    void Draw(const Texture& texture, const glm::vec3& topLeft, const glm::vec3& bottomRight,
+              float angle = 0.0f, float alpha = 1.0f, const glm::vec4& uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
+
+    // 刷新前按纹理稳定排序以减少绘制次数。
+    // 会改变不同纹理之间的前后遮挡顺序，只适用于互不重叠的精灵（默认关闭）
+    void SetSortByTexture(bool enable);
+    bool IsSortByTexture() const { return m_sortByTexture; }
+
+    // 提交已缓存的四边形
+    void Flush();
+    // 帧结束：提交剩余四边形并记录本帧统计
+    void EndFrame();
+    const SpriteBatchStats& GetLastFrameStats() const { return m_lastStats; }
+
+    SpriteBatch(const SpriteBatch&) = delete;
+    SpriteBatch& operator=(const SpriteBatch&) = delete;
+
+private:
+    SpriteBatch() = default;
+    ~SpriteBatch() = default;
+
+    // 顶点：NDC坐标、纹理坐标与透明度
+    struct SpriteVertex {
+        float x, y;
+        float u, v;
+        float alpha;
+    };
+    struct QueuedSprite {
+        unsigned int texture;
+        uint32_t first; // 在 m_vertices 中的起始顶点
+    };
+
+    static void FlushThunk(void* self) { static_cast<SpriteBatch*>(self)->Flush(); }
+    // 首次使用时创建GL资源（需要当前上下文）
+    void InitResources();
+
+    bool m_initialized = false;
+    bool m_sortByTexture = false;
+    Shader m_shader;
+    VertexArray* m_va = nullptr;
+    VertexBuffer* m_vb = nullptr;
+    unsigned int m_capacity = 0; // GPU缓冲区容量（字节）
+    std::vector<SpriteVertex> m_vertices;
+    std::vector<QueuedSprite> m_sprites;
+    std::vector<SpriteVertex> m_sorted;
+    SpriteBatchStats m_stats;
+    SpriteBatchStats m_lastStats;
+};
+
+} // namespace core
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "core/render/Texture.h"
+
+namespace core {
+
+// 流式纹理统计
+struct StreamingTextureStats {
+    unsigned long long framesUploaded = 0;
+    unsigned long long framesDropped = 0;   // 写入后未上传就被新帧取代，或没有空闲缓冲区
+    unsigned long long framesLate = 0;      // 定时帧：到期时已有更新的帧到期，被跳过
+};
+
+// 帧的像素格式
+enum class StreamFormat {
+    RGB24,      // 单平面 RGB
+    YUV420P,    // Y、U、V 三个平面，色度宽高各减半
+    NV12,       // Y 平面 + 交错的 UV 平面，色度宽高各减半
+};
+
+// 帧缓冲区中的一个平面（行紧密排列）
+struct StreamPlane {
+    int width = 0;
+    int height = 0;
+    int channels = 1;       // 每像素字节数
+    size_t offset = 0;      // 相对 BeginWrite 返回地址的偏移
+    int Stride() const { return width * channels; }
+};
+
+// 每帧整体更新的纹理（视频帧等）
+// YUV 格式每个平面各有一个纹理，绘制时由片段着色器转换为 RGB；GetTexture 返回的 Y 平面纹理已设置好着色器与附加纹理。
+// 纹理只分配一次、不使用mipmap，通过像素缓冲区环（GL_PIXEL_UNPACK_BUFFER）用 glTexSubImage2D 更新。
+// 支持 GL 4.4 / ARB_buffer_storage 时缓冲区持久映射，生产者线程直接写入映射内存；
+// 否则退化为CPU内存环，上传时由驱动复制。
+// 生产者（任意线程）：BeginWrite -> 写入 -> EndWrite；消费者（GL线程）：Update 上传最新的一帧。
+// 定时帧（视频）：生产者用 WaitWrite -> 写入 -> EndWrite(pts) 按顺序排队，缓冲区用完时等待而不是丢帧；
+// 消费者用 Update(clock) 上传 pts 已到期的最新一帧，未到期的帧留在环中。
+// 缓冲区正在被GPU读取时用栅栏保护，不会被覆盖
+class StreamingTexture {
+public:
+    // 需要在GL线程构造与析构
+    StreamingTexture(int width, int height, StreamFormat format = StreamFormat::RGB24, int slots = 3);
+    ~StreamingTexture();
+
+    // 取得可写的帧缓冲区，各平面位于 GetPlane(i).offset（行紧密排列）。没有空闲缓冲区时取代尚未上传的帧；
+    // 全部在使用中时返回 nullptr，本帧应丢弃
+    unsigned char* BeginWrite();
+    // 等待空闲缓冲区（不取代尚未显示的帧），超时返回 nullptr
+    unsigned char* WaitWrite(std::chrono::milliseconds timeout);
+    // 提交 BeginWrite 取得的缓冲区，成为最新帧
+    void EndWrite();
+    // 提交 WaitWrite 取得的缓冲区，作为显示时间为 pts（秒）的帧排在之前的帧之后
+    void EndWrite(double pts);
+    // 放弃 BeginWrite 取得的缓冲区
+    void CancelWrite();
+
+    // GL线程：上传最新的一帧，返回是否上传了新帧
+    bool Update();
+    // GL线程：上传 pts <= clock 的帧中最新的一帧，更早的帧跳过。
+    // pts 超前 clock 过多时视为时间轴跳变（循环播放回到开头等），立即显示
+    bool Update(double clock);
+    // 有已写入但尚未上传的帧；next 为最早一帧的 pts
+    bool PeekNext(double& next) const;
+    // GL线程：直接从内存上传一帧（布局与 BeginWrite 的缓冲区相同）
+    void Upload(const unsigned char* data);
+    // 至少上传过一帧
+    bool HasFrame() const { return m_hasFrame; }
+
+    const std::shared_ptr<Texture>& GetTexture() const { return m_texture; }
+    int GetWidth() const { return m_width; }
+    int GetHeight() const { return m_height; }
+    // 第一个平面的行距
+    int GetStride() const { return m_planes.empty() ? 0 : m_planes[0].Stride(); }
+    StreamFormat GetFormat() const { return m_format; }
+    int GetPlaneCount() const { return static_cast<int>(m_planes.size()); }
+    const StreamPlane& GetPlane(int index) const { return m_planes[index]; }
+    // YUV 格式的转换矩阵：bt709 为 false 时用 BT.601；fullRange 为 false 时按 16~235 的有限范围展开
+    void SetColorSpace(bool bt709, bool fullRange);
+    bool IsPersistent() const { return m_mapped != nullptr; }
+    StreamingTextureStats GetStats() const;
+
+    StreamingTexture(const StreamingTexture&) = delete;
+    StreamingTexture& operator=(const StreamingTexture&) = delete;
+
+private:
+    enum class SlotState { Free, Writing, Ready, InFlight };
+    struct Slot {
+        SlotState state = SlotState::Free;
+        GLsync fence = nullptr;   // InFlight 时有效
+        size_t offset = 0;        // 在持久映射缓冲区中的偏移
+        double pts = 0.0;
+        unsigned long long sequence = 0; // 提交顺序
+        std::vector<unsigned char> memory; // 非持久映射时的CPU内存
+    };
+
+    unsigned char* SlotData(Slot& slot);
+    // 把一帧的各平面上传到各自的纹理（pixels 为缓冲区偏移或内存地址）
+    void UploadPlanes(const unsigned char* pixels);
+    // 回收GPU已读取完成的缓冲区（调用时持有 m_mutex）
+    void RetireSlots();
+    // 最早提交的 Ready 缓冲区，没有时返回 -1（调用时持有 m_mutex）
+    int OldestReady() const;
+    // 上传 m_slots[index]；进入时持有锁，期间释放
+    void UploadSlot(int index, std::unique_lock<std::mutex>& lock);
+
+    int m_width = 0;
+    int m_height = 0;
+    size_t m_frameBytes = 0;
+    StreamFormat m_format = StreamFormat::RGB24;
+    std::vector<StreamPlane> m_planes;
+    std::shared_ptr<Texture> m_texture;                      // 第一个平面
+    std::vector<std::shared_ptr<Texture>> m_planeTextures;   // 与 m_planes 一一对应
+    std::shared_ptr<Shader> m_shader;                        // YUV 转换着色器
+    unsigned int m_buffer = 0;
+    unsigned char* m_mapped = nullptr;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_slotFreed;  // WaitWrite 等待空闲缓冲区
+    std::vector<Slot> m_slots;
+    int m_writing = -1;
+    unsigned long long m_sequence = 0;
+    bool m_hasFrame = false;
+    StreamingTextureStats m_stats;
+};
+
+} // namespace core
@@ -23,7 +23,10 @@ namespace core {
 class Texture {
     public:
         Texture(const unsigned char* data, const int width, const int height, bool isRGB = false);
-        Texture(const int width, const int height, bool isRGB = false);
+        // mipmaps 为 false 时只分配第0级并使用线性过滤（每帧整体更新的纹理）
+        Texture(const int width, const int height, bool isRGB = false, bool mipmaps = true);
+        // 指定像素格式（如视频平面的 GL_R8 / GL_RED）
+        Texture(const int width, const int height, unsigned int internalFormat, unsigned int format, bool mipmaps);
         Texture(const Texture& texture)=delete;
         Texture(){init();}
         ~Texture();
@@ -31,7 +34,7 @@ class Texture {
         void bind() const;
         void Bind() const {bind();}
         static void unbind() {
-            GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+            GLStateCache::Get().BindTexture(GL_TEXTURE_2D, 0);
         }
 
         int getWidth() const {return width;}
@@ -42,8 +45,16 @@ class Texture {
         * @param topLeft 左上角坐标
         * @param bottomRight 右下角坐标
         * @param angle 旋转角度
+        * @param uvRect 采样的子矩形 (u0, v0, u1, v1)，v0 为图像顶部，默认整张纹理
         * */
-        void Draw(const glm::vec3& topLeft, const glm::vec3& bottomRight, float angle = 0.0f, float alpha = 1.0f) const;
+        void Draw(const glm::vec3& topLeft, const glm::vec3& bottomRight, float angle = 0.0f, float alpha = 1.0f,
+                  const glm::vec4& uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f)) const;
+
+        // 更新纹理的一个矩形区域（RGBA），不重新生成mipmap
+        void SubImage(int x, int y, int w, int h, const unsigned char* data);
+        void GenerateMipmap();
+        // Draw 发出的 glDraw* 次数（自上次调用以来），返回后清零
+        static unsigned int TakeDrawCalls();
 
 
         operator bool() const {return textureID != 0;}
@@ -51,6 +62,11 @@ class Texture {
 
         bool setCustomerShaderProgram(const std::string& vertexShader, const std::string& fragmentShader);
         bool setCustomerShaderProgram(const Shader& shader);
+        bool hasCustomerShaderProgram() const {return customerShaderProgram != nullptr;}
+        // 绘制时额外绑定到纹理单元 unit（从1开始）的纹理，采样器名为 sampler
+        void setCustomerTexture(unsigned int unit, const std::string& sampler, unsigned int textureID);
+        // 默认顶点着色器（自定义片段着色器可与之搭配）
+        static const std::string& DefaultVertexShader();
         void setCustomerVertexArray(const VertexArray& va);
         void setCustomerVertexBuffer(const VertexBuffer& vb);
         void setCustomerIndexBuffer(const IndexBuffer& ib);
@@ -59,6 +75,7 @@ class Texture {
     private:
         void init();
         static bool inited;
+        static unsigned int drawCalls;
         
         unsigned int textureID=0;
         int width=0, height=0;
@@ -75,6 +92,12 @@ class Texture {
         std::shared_ptr<VertexArray> customerVAO=nullptr;
         std::shared_ptr<VertexBuffer> customerVBO=nullptr;
         std::shared_ptr<IndexBuffer> customerIBO=nullptr;
+        struct CustomerTexture {
+            unsigned int unit;
+            std::string sampler;
+            unsigned int textureID;
+        };
+        std::vector<CustomerTexture> customerTextures;
         std::vector<float> customerVertices;
         std::vector<unsigned int> customerIndices;
     };
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "GlyphAtlas.h"
+#include "Texture.h"
+
+namespace core {
+
+// 小图片图集：加载时把图标等小位图装入共享的RGBA页，
+// 位图只记录所在页与UV子矩形，同一页上的位图共用一张纹理
+class TextureAtlas {
+public:
+    struct Sprite {
+        std::shared_ptr<Texture> texture; // 所在页的纹理
+        uint32_t page = 0;
+        glm::vec4 uv{0.0f, 0.0f, 1.0f, 1.0f}; // u0, v0（图像顶部）, u1, v1（图像底部）
+    };
+
+    static TextureAtlas& Get();
+
+    // 宽高都不超过该值的图像才放入图集
+    static constexpr int MaxSpriteSize = 256;
+    static constexpr int PageSize = 2048;
+    // 边距内复制边缘像素，线性过滤与前两级mipmap不会采样到相邻图像
+    static constexpr int Padding = 4;
+
+    bool Accepts(int width, int height) const;
+    // 放入一张 RGBA 图像，成功时返回所在页与UV
+    bool Add(const unsigned char* rgba, int width, int height, Sprite& out);
+    // 为有新图像的页重新生成mipmap（绘制前调用，无变化时无开销）
+    void Commit();
+    bool HasPendingUploads() const { return dirtyCount > 0; }
+
+    size_t GetPageCount() const { return pages.size(); }
+    size_t GetSpriteCount() const { return spriteCount; }
+
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+private:
+    TextureAtlas();
+    std::shared_ptr<Texture> CreatePage();
+
+    // 装箱复用字形图集的货架算法；位图常驻，页数不设上限，不会发生驱逐
+    GlyphAtlas packer;
+    std::vector<std::shared_ptr<Texture>> pages;
+    std::vector<bool> dirty;
+    size_t dirtyCount = 0;
+    size_t spriteCount = 0;
+    // 上传时使用的临时缓冲（包含边距）
+    std::vector<unsigned char> scratch;
+};
+
+} // namespace core
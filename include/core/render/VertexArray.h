@@ -1,5 +1,6 @@
 #pragma once
 #include "GLBase.h"
+#include "GLStateCache.h"
 
 #include "VertexBuffer.h"
 #include "IndexBuffer.h"
@@ -19,8 +20,8 @@ public:
 	VertexArray();
 	VertexArray(const VertexArray& va);
 	~VertexArray();
-	void Bind() const { GLCall(glBindVertexArray(rendererID)); };
-	static void Unbind() { GLCall(glBindVertexArray(0)); };
+	void Bind() const { GLStateCache::Get().BindVertexArray(rendererID); };
+	static void Unbind() { GLStateCache::Get().BindVertexArray(0); };
 
 	// 添加缓冲区并设置属性指针
 	void AddBuffer(const VertexBuffer& vb, unsigned int index, unsigned int size, unsigned int type, bool normalized, unsigned int stride, const void* pointer) const;
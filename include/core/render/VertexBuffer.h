@@ -1,6 +1,7 @@
 #pragma once
 #include <glad/glad.h>
 #include "GLBase.h"
+#include "GLStateCache.h"
 
 
 namespace core {
@@ -14,10 +15,10 @@ public:	VertexBuffer(){GLCall(glGenBuffers(1, &rendererID));}
 	VertexBuffer(const VertexBuffer& vb);
 	~VertexBuffer();
 
-	void Bind() const{ GLCall(glBindBuffer(GL_ARRAY_BUFFER, rendererID)); } ;
-	static void Unbind(){GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));};
+	void Bind() const{ GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, rendererID); } ;
+	static void Unbind(){GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, 0);};
 
-	void BufferData(const void* data, unsigned int size);
+	void BufferData(const void* data, unsigned int size, unsigned int usage = GL_STATIC_DRAW);
 	void BufferSubData(unsigned int offset, unsigned int size, const void* data) const;
 
 	inline unsigned int getRendererID() const { return rendererID; }
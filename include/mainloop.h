@@ -20,6 +20,7 @@ void CharEvent(GLFWwindow* window, unsigned int codepoint); // Unicode字符输
 void MouseButtonEvent(GLFWwindow* window, int button, int action, int mods);
 void MouseMoveEvent(GLFWwindow* window, double xpos, double ypos); // 鼠标移动回调
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void WindowRefreshEvent(GLFWwindow* window); // 窗口内容失效回调
 
 int init();
 int cleanup();
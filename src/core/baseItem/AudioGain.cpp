@@ -0,0 +1,250 @@
+#include "core/baseItem/AudioGain.h"
+#include "core/log.h"
+
+#include <algorithm>
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define AUDIO_GAIN_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define AUDIO_GAIN_NEON 1
+#include <arm_neon.h>
+#endif
+
+// GCC/Clang 需要为单个函数开启 AVX2，MSVC 可以直接使用其指令
+#if defined(AUDIO_GAIN_X86) && defined(__GNUC__)
+#define AUDIO_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define AUDIO_TARGET_AVX2
+#endif
+
+using namespace core;
+
+namespace {
+
+// 处理 n 个样本：dst = (mix ? dst : 0) + src * gain，gain 在 [0, kUnityGain] 内且不变
+using GainKernel = void (*)(int16_t* dst, const int16_t* src, size_t n, int gain, bool mix);
+
+void GainScalar(int16_t* dst, const int16_t* src, size_t n, int gain, bool mix) {
+    if (gain >= kUnityGain && !mix && dst == src) return;
+    for (size_t i = 0; i < n; ++i) {
+        // 四舍五入的Q15乘法；|gain| < 1 时结果不会超出 int16
+        int32_t value = gain >= kUnityGain
+            ? src[i]
+            : (static_cast<int32_t>(src[i]) * gain + 0x4000) >> 15;
+        if (mix) value += dst[i];
+        dst[i] = static_cast<int16_t>(std::clamp(value, -32768, 32767));
+    }
+}
+
+#if defined(AUDIO_GAIN_X86)
+void GainSSE2(int16_t* dst, const int16_t* src, size_t n, int gain, bool mix) {
+    size_t i = 0;
+    if (gain >= kUnityGain) {
+        if (mix) {
+            for (; i + 8 <= n; i += 8) {
+                const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_adds_epi16(d, s));
+            }
+        }
+    } else {
+        const __m128i g = _mm_set1_epi16(static_cast<short>(gain));
+        const __m128i round = _mm_set1_epi32(0x4000);
+        for (; i + 8 <= n; i += 8) {
+            const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            // 16x16 -> 32位乘积由高低两半拼出
+            const __m128i lo = _mm_mullo_epi16(s, g);
+            const __m128i hi = _mm_mulhi_epi16(s, g);
+            const __m128i p0 = _mm_srai_epi32(_mm_add_epi32(_mm_unpacklo_epi16(lo, hi), round), 15);
+            const __m128i p1 = _mm_srai_epi32(_mm_add_epi32(_mm_unpackhi_epi16(lo, hi), round), 15);
+            __m128i result = _mm_packs_epi32(p0, p1);
+            if (mix) {
+                result = _mm_adds_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i)), result);
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), result);
+        }
+    }
+    GainScalar(dst + i, src + i, n - i, gain, mix);
+}
+
+AUDIO_TARGET_AVX2 void GainAVX2(int16_t* dst, const int16_t* src, size_t n, int gain, bool mix) {
+    size_t i = 0;
+    if (gain >= kUnityGain) {
+        if (mix) {
+            for (; i + 16 <= n; i += 16) {
+                const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+                const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_adds_epi16(d, s));
+            }
+        }
+    } else {
+        const __m256i g = _mm256_set1_epi16(static_cast<short>(gain));
+        const __m256i round = _mm256_set1_epi32(0x4000);
+        for (; i + 16 <= n; i += 16) {
+            const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            // unpack 与 pack 都按128位分别进行，样本顺序保持不变
+            const __m256i lo = _mm256_mullo_epi16(s, g);
+            const __m256i hi = _mm256_mulhi_epi16(s, g);
+            const __m256i p0 = _mm256_srai_epi32(_mm256_add_epi32(_mm256_unpacklo_epi16(lo, hi), round), 15);
+            const __m256i p1 = _mm256_srai_epi32(_mm256_add_epi32(_mm256_unpackhi_epi16(lo, hi), round), 15);
+            __m256i result = _mm256_packs_epi32(p0, p1);
+            if (mix) {
+                result = _mm256_adds_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i)), result);
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), result);
+        }
+    }
+    GainScalar(dst + i, src + i, n - i, gain, mix);
+}
+
+bool HasAVX2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    // 操作系统需要保存 YMM 寄存器
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+#if defined(AUDIO_GAIN_NEON)
+void GainNEON(int16_t* dst, const int16_t* src, size_t n, int gain, bool mix) {
+    size_t i = 0;
+    if (gain >= kUnityGain) {
+        if (mix) {
+            for (; i + 8 <= n; i += 8) {
+                vst1q_s16(dst + i, vqaddq_s16(vld1q_s16(dst + i), vld1q_s16(src + i)));
+            }
+        }
+    } else {
+        const int16x4_t g = vdup_n_s16(static_cast<int16_t>(gain));
+        for (; i + 8 <= n; i += 8) {
+            const int16x8_t s = vld1q_s16(src + i);
+            // vqrshrn 的舍入（加 1<<14 后右移）与标量实现相同
+            const int32x4_t p0 = vmull_s16(vget_low_s16(s), g);
+            const int32x4_t p1 = vmull_s16(vget_high_s16(s), g);
+            int16x8_t result = vcombine_s16(vqrshrn_n_s32(p0, 15), vqrshrn_n_s32(p1, 15));
+            if (mix) {
+                result = vqaddq_s16(vld1q_s16(dst + i), result);
+            }
+            vst1q_s16(dst + i, result);
+        }
+    }
+    GainScalar(dst + i, src + i, n - i, gain, mix);
+}
+#endif
+
+bool Supports(AudioKernel kernel) {
+    switch (kernel) {
+    case AudioKernel::Scalar:
+        return true;
+#if defined(AUDIO_GAIN_X86)
+    case AudioKernel::SSE2:
+        return true;
+    case AudioKernel::AVX2:
+        return HasAVX2();
+#endif
+#if defined(AUDIO_GAIN_NEON)
+    case AudioKernel::NEON:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+GainKernel KernelFunction(AudioKernel kernel) {
+    switch (kernel) {
+#if defined(AUDIO_GAIN_X86)
+    case AudioKernel::SSE2: return GainSSE2;
+    case AudioKernel::AVX2: return GainAVX2;
+#endif
+#if defined(AUDIO_GAIN_NEON)
+    case AudioKernel::NEON: return GainNEON;
+#endif
+    default: return GainScalar;
+    }
+}
+
+AudioKernel DetectKernel() {
+    AudioKernel kernel = AudioKernel::Scalar;
+    for (AudioKernel candidate : { AudioKernel::AVX2, AudioKernel::SSE2, AudioKernel::NEON }) {
+        if (Supports(candidate)) {
+            kernel = candidate;
+            break;
+        }
+    }
+    Log << Level::Info << "音频增益内核: " << GetAudioKernelName(kernel) << op::endl;
+    return kernel;
+}
+
+std::atomic<AudioKernel>& CurrentKernel() {
+    static std::atomic<AudioKernel> kernel{ DetectKernel() };
+    return kernel;
+}
+
+// 块的增益：按块起点在整段中的位置线性插值
+int BlockGain(int startGain, int endGain, size_t offset, size_t count) {
+    const int64_t delta = static_cast<int64_t>(endGain - startGain) * static_cast<int64_t>(offset);
+    return startGain + static_cast<int>(delta / static_cast<int64_t>(count));
+}
+
+void Process(int16_t* dst, const int16_t* src, size_t count, int startGain, int endGain, bool mix) {
+    if (!dst || !src || count == 0) return;
+    startGain = std::clamp(startGain, 0, kUnityGain);
+    endGain = std::clamp(endGain, 0, kUnityGain);
+    const GainKernel kernel = KernelFunction(CurrentKernel().load(std::memory_order_relaxed));
+    if (startGain == endGain) {
+        kernel(dst, src, count, startGain, mix);
+        return;
+    }
+    for (size_t offset = 0; offset < count; offset += kGainRampBlock) {
+        const size_t n = std::min(kGainRampBlock, count - offset);
+        kernel(dst + offset, src + offset, n, BlockGain(startGain, endGain, offset, count), mix);
+    }
+}
+
+} // namespace
+
+int core::GainToQ15(float gain) {
+    return static_cast<int>(std::clamp(gain, 0.0f, 1.0f) * kUnityGain + 0.5f);
+}
+
+void core::ApplyGainS16(int16_t* samples, size_t count, int startGain, int endGain) {
+    Process(samples, samples, count, startGain, endGain, false);
+}
+
+void core::MixS16(int16_t* dst, const int16_t* src, size_t count, int startGain, int endGain) {
+    Process(dst, src, count, startGain, endGain, true);
+}
+
+AudioKernel core::GetAudioKernel() {
+    return CurrentKernel().load(std::memory_order_relaxed);
+}
+
+const char* core::GetAudioKernelName(AudioKernel kernel) {
+    switch (kernel) {
+    case AudioKernel::SSE2: return "SSE2";
+    case AudioKernel::AVX2: return "AVX2";
+    case AudioKernel::NEON: return "NEON";
+    default: return "Scalar";
+    }
+}
+
+bool core::SetAudioKernel(AudioKernel kernel) {
+    if (!Supports(kernel)) return false;
+    CurrentKernel().store(kernel, std::memory_order_relaxed);
+    return true;
+}
@@ -2,6 +2,11 @@
 
 #include "core/log.h"
 #include "core/baseItem/Base.h"
+#include "core/Config.h"
+#include "core/configItem.h"
+#include "core/render/SpriteBatch.h"
+#include "core/render/TextureAtlas.h"
+#include "core/render/Profiler.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
@@ -14,6 +19,13 @@
 
 using namespace core;
 
+Bitmap::Bitmap(std::shared_ptr<Texture> texture) : texture(std::move(texture)) {
+    if (this->texture) {
+        m_width = this->texture->getWidth();
+        m_height = this->texture->getHeight();
+    }
+}
+
 Bitmap::Bitmap(int width, int height, bool createTexture, bool useRGB) {
     m_width = width;
     m_height = height;
@@ -31,6 +43,25 @@ Bitmap::Bitmap(int width, int height, bool createTexture, bool useRGB) {
     }
 }
 
+void Bitmap::CreateTextureFromRGBA(const unsigned char* data, int width, int height)
+{
+    m_width = width;
+    m_height = height;
+    m_uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+    m_inAtlas = false;
+    // 小图标放入共享图集，同一页上的位图可以合并绘制
+    if (TextureAtlas::Get().Accepts(width, height) && Config::getInstance()->getBool(TEXTURE_ATLAS, true)) {
+        TextureAtlas::Sprite sprite;
+        if (TextureAtlas::Get().Add(data, width, height, sprite)) {
+            texture = sprite.texture;
+            m_uvRect = sprite.uv;
+            m_inAtlas = true;
+            return;
+        }
+    }
+    texture = std::make_shared<Texture>(data, width, height);
+}
+
 bool Bitmap::Load(const std::string& filePath)
 {
     if (texture)    
@@ -55,7 +86,7 @@ bool Bitmap::Load(const std::string& filePath)
     unsigned char* data = stbi_load(filePath.c_str(), &width, &height, &channels, 4);
     if (data)
     {
-        texture = std::make_shared<Texture>(data, width, height);
+        CreateTextureFromRGBA(data, width, height);
         stbi_image_free(data);
         Log<<Level::Info << "Loaded image: " << filePath << op::endl;
         return true;
@@ -138,7 +169,7 @@ bool Bitmap::LoadWebP(const std::string& filePath)
     }
     
     // 创建纹理
-    texture = std::make_shared<Texture>(decodedData, width, height);
+    CreateTextureFromRGBA(decodedData, width, height);
     
     // 释放解码后的数据
     if (hasAlpha) {
@@ -161,6 +192,8 @@ bool Bitmap::CreateFromRGBData(const unsigned char* data, int width, int height,
     m_width = width;
     m_height = height;
     m_useRGB = directRGB;
+    m_uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+    m_inAtlas = false;
     
     // 清理旧的资源
     if (rgbData) {
@@ -245,7 +278,8 @@ void Bitmap::CreateTextureFromBuffer() {
     rgbData = nullptr;
 }
 
-void Bitmap::Draw(Region region, float alpha) {
+void Bitmap::Draw(Region region, float alpha, bool batched) {
+    PROFILE_SCOPE("bitmap draw");
     // 确保在绘制前有纹理
     if (!texture) {
         if (rgbData) {
@@ -285,5 +319,12 @@ void Bitmap::Draw(Region region, float alpha) {
     glm::vec3 topLeft = screenToNDC(region.getx(), region.gety());
     glm::vec3 bottomRight = screenToNDC(region.getxend(), region.getyend());
 
-    texture->Draw(topLeft, bottomRight, 0, alpha);
+    // 图集页上新放入的图像需要先生成mipmap
+    if (m_inAtlas) TextureAtlas::Get().Commit();
+    // 自定义着色器（如视频的YUV转换）不能与其他精灵合并
+    if (batched && !texture->hasCustomerShaderProgram()) {
+        SpriteBatch::Get().Draw(*texture, topLeft, bottomRight, 0, alpha, m_uvRect);
+        return;
+    }
+    texture->Draw(topLeft, bottomRight, 0, alpha, m_uvRect);
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "core/explorer.h"
 #include "core/log.h"
 #include "core/render/Drawer.h"
+#include "core/render/DamageTracker.h"
 #include "core/Config.h"
 #include <thread>
 #include <chrono>
@@ -83,11 +84,11 @@ void Button::Draw(unsigned char alpha) {
     }
     if (enableBitmap) {
         if(bitmapPtr && *bitmapPtr)
-            (*bitmapPtr)->Draw(region, finalAlpha/255.0f);
+            (*bitmapPtr)->Draw(region, finalAlpha/255.0f, batchBitmap);
         else if(bitmapid != BitmapID::Unknown && core::Explorer::getInstance()->isBitmapLoaded(bitmapid)) {
             bitmapPtr = core::Explorer::getInstance()->getBitmapPtr(bitmapid);
             if (bitmapPtr && *bitmapPtr) {
-                (*bitmapPtr)->Draw(region, finalAlpha / 255.0f);
+                (*bitmapPtr)->Draw(region, finalAlpha / 255.0f, batchBitmap);
             } else {
                 Log << "Bitmap with ID " << int(bitmapid) << " not found." << op::endl;
             }
@@ -197,7 +198,9 @@ void Button::MoveTo(const Region& region, const bool enableFluent, const float s
             if (distance < 1.0f) {
                 std::unique_lock<std::timed_mutex> animLock(button.animMutex, std::defer_lock);
                 if (animLock.try_lock_for(std::chrono::milliseconds(100))) {
+                    button.MarkDirty(button.region);
                     button.region = targetRegion;
+                    button.MarkDirty(button.region);
                     button.animationRunning = false;
                 } else {
                     Log << Level::Warn << "Button::MoveTo - 无法获取锁设置最终位置" << op::endl;
@@ -237,10 +240,12 @@ void Button::MoveTo(const Region& region, const bool enableFluent, const float s
                     std::unique_lock<std::timed_mutex> animLock(button.animMutex, std::defer_lock);
                     if (animLock.try_lock_for(std::chrono::milliseconds(50))) {
                         if (!button.stopRequested) {
+                            button.MarkDirty(button.region);
                             button.region.setx(newX);
                             button.region.setxend(newXend);
                             button.region.sety(newY);
                             button.region.setyend(newYend);
+                            button.MarkDirty(button.region);
                         }
                     } else {
                         // 如果无法获取锁，记录警告但继续动画
@@ -253,7 +258,9 @@ void Button::MoveTo(const Region& region, const bool enableFluent, const float s
             if (!button.stopRequested) {
                 std::unique_lock<std::timed_mutex> animLock(button.animMutex, std::defer_lock);
                 if (animLock.try_lock_for(std::chrono::milliseconds(100))) {
+                    button.MarkDirty(button.region);
                     button.region = targetRegion;
+                    button.MarkDirty(button.region);
                 } else {
                     Log << Level::Warn << "Button::MoveTo - 无法获取锁设置最终位置" << op::endl;
                 }
@@ -282,7 +289,9 @@ void Button::MoveTo(const Region& region, const bool enableFluent, const float s
             }
         }
         
+        MarkDirty(this->region);
         this->region = region;
+        MarkDirty(this->region);
         if (onComplete) {
             try {
                 onComplete();
@@ -293,6 +302,14 @@ void Button::MoveTo(const Region& region, const bool enableFluent, const float s
     }
 }
 
+void Button::MarkDirty(const Region& area) const
+{
+    // 编辑模式的边框与控制点会画到区域外
+    const float margin = editHandleSize + editBorderWidth;
+    DamageTracker::Get().Invalidate(area.getx() - margin, area.gety() - margin,
+        area.getxend() + margin, area.getyend() + margin);
+}
+
 void Button::SetFontID(FontID id)
 {
     this->fontid = id;
@@ -331,6 +348,7 @@ void Button::FadeOut(float duration, unsigned char startAlpha, unsigned char end
             std::lock_guard<std::timed_mutex> lock(button.fadeMutex);
             button.currentFadeAlpha = endAlpha;
             button.fadeAnimationRunning = false;
+            button.MarkDirty(button.region);
             
             // 如果有回调函数，则执行它
             if (callback && *callback) {
@@ -362,6 +380,7 @@ void Button::FadeOut(float duration, unsigned char startAlpha, unsigned char end
                 std::lock_guard<std::timed_mutex> lock(button.fadeMutex);
                 if (!button.fadeStopRequested) {
                     button.currentFadeAlpha = newAlpha;
+                    button.MarkDirty(button.region);
                 }
             }
             
@@ -374,6 +393,7 @@ void Button::FadeOut(float duration, unsigned char startAlpha, unsigned char end
         if (!button.fadeStopRequested) {
             std::lock_guard<std::timed_mutex> lock(button.fadeMutex);
             button.currentFadeAlpha = endAlpha;
+            button.MarkDirty(button.region);
         }
         
         button.fadeAnimationRunning = false;
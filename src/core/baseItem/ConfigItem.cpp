@@ -5,6 +5,7 @@
 #include "core/baseItem/Base.h"
 #include "core/explorer.h"
 #include "core/screen/base.h"
+#include "core/render/RenderAPI.h"
 
 #include <GLFW/glfw3.h>
 #ifdef _WIN32
@@ -24,6 +25,7 @@ boolconfig GetBoolConfigFromString(const std::string& configName) {
     if (configName == DEBUG) return boolconfig::debug;
     if (configName == SHOW_FPS) return boolconfig::show_fps;
     if (configName == VERTICAL_SYNC) return boolconfig::vertical_sync;
+    if (configName == SHOW_PROFILER) return boolconfig::show_profiler;
     return boolconfig::unknown; // 如果没有匹配的配置名，返回未知配置
 }
 
@@ -33,6 +35,7 @@ void LoadBoolsFromConfig() {
     bools[boolconfig::inwindow] = config->getBool(INWINDOW);
     bools[boolconfig::debug] = config->getBool(DEBUG);
     bools[boolconfig::show_fps] = config->getBool(SHOW_FPS);
+    bools[boolconfig::show_profiler] = config->getBool(SHOW_PROFILER);
 }
 
 void fullscreen(GLFWwindow* window){
@@ -59,7 +62,7 @@ void fullscreen(GLFWwindow* window){
     glfwSetWindowPos(window, 0, 0);
     glfwSetWindowSize(window, core::screenInfo.width, core::screenInfo.height);
     
-    glViewport(0, 0, core::screenInfo.width, core::screenInfo.height);
+    core::RenderAPI::Get().Viewport(0, 0, core::screenInfo.width, core::screenInfo.height);
     glfwSwapBuffers(window);
     Log << Level::Info << "Switched to fullscreen mode: " << core::screenInfo.width << "x" << core::screenInfo.height << "@" << GLFW_DONT_CARE << "Hz" << op::endl;
 }
@@ -102,7 +105,7 @@ void defullscreen(GLFWwindow* window){
     core::WindowInfo.aspectRatio = (float)width / (float)height;
     
     // 更新视口
-    glViewport(0, 0, width, height);
+    core::RenderAPI::Get().Viewport(0, 0, width, height);
     
     Log << Level::Info << "切换到普通窗口模式 (" << windowWidth << "x" << windowHeight << ")" << op::endl;
 }
@@ -113,6 +116,7 @@ void SyncConfig() {
     config->set(INWINDOW, bools[boolconfig::inwindow]);
     config->set(DEBUG, bools[boolconfig::debug]);
     config->set(SHOW_FPS, bools[boolconfig::show_fps]);
+    config->set(SHOW_PROFILER, bools[boolconfig::show_profiler]);
     config->saveToFile();
     // 设置全屏
     if(!bools[boolconfig::inwindow])fullscreen(core::WindowInfo.window);
@@ -145,10 +149,20 @@ void SetConfigItems(){
     config->setifno(WINDOW_X,100);
     config->setifno(WINDOW_Y,100);
     config->setifno(VERTICAL_SYNC, 1);
+    config->setifno(TARGET_FPS, 0);
+    config->setifno(MAX_FRAMES_IN_FLIGHT, 2);
     config->setifno(WINDOW_TITLE, text("window.title"));
     config->setifno(DEBUG, 0);
     config->setifno(SHOW_FPS,0);
+    config->setifno(SHOW_PROFILER,0);
     config->setifno(VOLUME, 100);
+    config->setifno(GLYPH_CACHE, 1);
+    config->setifno(FONT_SDF, 0);
+    config->setifno(TEXTURE_ATLAS, 1);
+    config->setifno(ON_DEMAND_RENDER, 0);
+    config->setifno(PARTIAL_REDRAW, 0);
+    config->setifno(VIDEO_HWACCEL, "auto");
+    config->setifno(VIDEO_DECODE_THREADS, 0);
 
     config->setifno(UI_REGION_EXIT, core::Region{0.9,0.03,0.95,-1});
     config->setifno(UI_REGION_EXIT_EDIT, core::Region{0.85,0.4,0.95,0.43});
@@ -3,13 +3,16 @@
 #include "core/baseItem/Font.h"
 #include FT_FREETYPE_H
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
-#include <mutex>
 #include <filesystem>
 
 #include "core/baseItem/Base.h"
+#include "core/Config.h"
 #include "core/configItem.h"
 #include "core/log.h"
+#include "core/render/Profiler.h"
 
 using namespace core;
 
@@ -17,9 +20,15 @@ FT_Library Font::ft = nullptr;
 IFontRenderer* Font::fontRenderer = nullptr;
 
 std::shared_ptr<Font> Font::spare_font = nullptr;
+bool Font::asyncRasterization = true;
+bool Font::atlasPlacementFailed = false;
+size_t Font::uploadBudgetBytes = 256 * 1024;
+uint64_t Font::nextFontId = 1;
+std::unordered_map<uint64_t, Font*> Font::registry;
+std::deque<std::unique_ptr<GlyphRasterizer::Result>> Font::uploadBacklog;
 
 Font::Font(const std::string& fontPath,bool needPreLoad, unsigned int fontSize)
-	: fontSize(fontSize), face(nullptr), isOK(false)
+	: fontSize(fontSize), requestedSize(fontSize), face(nullptr), isOK(false)
 {
 	std::cout << "loading Font file "<<fontPath<<std::endl;
 	if(!std::filesystem::exists(fontPath)){
@@ -29,41 +38,39 @@ Font::Font(const std::string& fontPath,bool needPreLoad, unsigned int fontSize)
 		Log << Level::Error << "Font renderer not set. Call Font::SetFontRenderer(...) before creating Font" << op::endl;
 		return;
 	}
-	// 初始化 FreeType 字库
-	if(ft==nullptr) {
-		if (FT_Init_FreeType(&ft)) {
-			std::cerr << "无法初始化 FreeType 库" << std::endl;
-			return;
-		}
-	}
 	static bool spareIniting = false;
 	// 初始化备用字体
 	if (!spare_font&&!spareIniting) {
 		spareIniting = true;
 		spare_font = std::make_shared<Font>("files/fonts/spare.ttf", 0);
 	}
-	face = nullptr;
-	// 加载字体
-	if (FT_New_Face(ft, fontPath.c_str(), 0, &face)) {
-		std::cerr << "无法加载字体: " << fontPath << std::endl;
-		FT_Done_FreeType(ft);
-		isOK=false;
-		return;
+	this->fontPath = fontPath;
+	// 距离场模式：以固定大小光栅化，显示大小的差异并入缩放
+	distanceField = Config::getInstance()->getBool(FONT_SDF, false);
+	if (distanceField && fontSize > 0) {
+		this->fontSize = DistanceFieldRasterSize;
+		sizeFactor = static_cast<float>(fontSize) / static_cast<float>(DistanceFieldRasterSize);
+	}
+	fontId = nextFontId++;
+	registry[fontId] = this;
+	// 字形磁盘缓存：命中的字形不经过FreeType
+	if (Config::getInstance()->getBool(GLYPH_CACHE, true)) {
+		glyphCache = std::make_unique<GlyphCache>(fontPath, this->fontSize, distanceField);
+	}
+	// 没有可用缓存时立即加载字体，以便尽早发现字体文件错误；否则在首次缓存未命中时再加载
+	if (!glyphCache || glyphCache->GetMappedCount() == 0) {
+		if (!EnsureFace()) {
+			isOK=false;
+			return;
+		}
 	}
-	// 设置字体大小
-	FT_Set_Pixel_Sizes(face, 0, fontSize);
 
-	// 预加载字符（如果需要）
+	// 预加载ASCII字符（如果需要），中文等其他字符在首次使用时加载
 	if (needPreLoad)
 	{
 		for (wchar_t c = 0; c < 128; c++) {
 			LoadCharacter(c);
 		}
-
-		for (wchar_t c = 0x4e00; c < 0x9fa5; c++)
-		{
-			LoadCharacter(c);
-		}
 	}
 	else
 	{
@@ -78,16 +85,11 @@ Font::Font(const std::string& fontPath,bool needPreLoad, unsigned int fontSize)
 }
 
 Font::~Font() {
-	for (auto& pair : Characters) {
-		try {
-			if (Font::fontRenderer) Font::fontRenderer->DeleteTexture(pair.second.TextureID);
-		} catch (const std::exception& e) {
-			Log << Level::Error << "Exception while deleting texture for character: " << e.what() << op::endl;
-		} catch (...) {
-			Log << Level::Error << "Unknown exception while deleting texture" << op::endl;
-		}
-	}
-
+	// 之后到达的光栅化结果将被丢弃
+	registry.erase(fontId);
+	// 字形位于渲染后端共享的图集中，不单独释放，由图集的LRU回收
+	// 析构缓存时写回本次新光栅化的字形
+	glyphCache.reset();
 	// 释放 FreeType 资源
 	if (face) {
 		FT_Done_Face(face);
@@ -95,64 +97,39 @@ Font::~Font() {
 }
 
 void Font::RenderText(const std::string& text,float x, float y,float scale, const glm::vec4& color){
-	std::wstring wtext = string2wstring(text);
-	RenderText(wtext, x, y, scale, color);
+	RenderLayout(AsBytes(text), false, LayoutMode::Line, x, y, 0.0f, 0.0f, scale, color);
+}
+
+void Font::RenderText(const std::wstring& text, float x, float y, float scale, const glm::vec4& color) {
+	RenderLayout(AsBytes(text), true, LayoutMode::Line, x, y, 0.0f, 0.0f, scale, color);
 }
 
-void Font::RenderText(const std::wstring& text, float x, float y_origin, float scale, const glm::vec4& color) {
+void Font::LayoutLine(const std::wstring& text, float x, float y_origin, float scale, std::vector<LayoutQuad>& out) {
 	scale = CalculateDynamicScale(scale);
 	float y=WindowInfo.height-y_origin-fontSize*scale;
-	//检查是否包含未加载的字符
-	for (auto c = text.begin(); c != text.end(); ++c) {
-		if (!Characters.contains(*c))
-		{
-			LoadCharacter(*c);
-		}
-	}
-	// 设置正交投影矩阵
-	glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(WindowInfo.width), 0.0f, static_cast<float>(WindowInfo.height));
-	// 使用渲染器设置投影和颜色
-	Font::fontRenderer->SetProjection(projection);
-	Font::fontRenderer->SetTextColor(glm::vec3(color.r, color.g, color.b), color.a);
-	Font::fontRenderer->PrepareForText();
+	// 先解析全部字形（按需加载），再统一排版
+	ResolveRun(text);
 
 	// 遍历文本中的字符
-	for (auto c = text.begin(); c != text.end(); ++c) {
-		Character ch = Characters[*c];
-
-		float xpos = x + ch.Bearing.x * scale;
-		float ypos = y - (ch.Size.y - ch.Bearing.y) * scale;
+	for (const Character& ch : runGlyphs) {
+		if (ch.Slot.IsValid()) {
+			float xpos = x + ch.Bearing.x * scale;
+			float ypos = y - (ch.Size.y - ch.Bearing.y) * scale;
 
-		float w = ch.Size.x * scale;
-		float h = ch.Size.y * scale;
+			float w = ch.Size.x * scale;
+			float h = ch.Size.y * scale;
 
-		// 更新 VBO 数据
-		float vertices[6][4] = {
-			{ xpos,     ypos + h,   0.0f, 0.0f },
-			{ xpos,     ypos,       0.0f, 1.0f },
-			{ xpos + w, ypos,       1.0f, 1.0f },
-
-			{ xpos,     ypos + h,   0.0f, 0.0f },
-			{ xpos + w, ypos,       1.0f, 1.0f },
-			{ xpos + w, ypos + h,   1.0f, 0.0f }
-		};
-
-		// 绑定纹理由后端管理
-		Font::fontRenderer->BindTexture(ch.TextureID);
-		// 更新顶点缓冲并绘制
-		Font::fontRenderer->UpdateVertexBuffer(vertices, sizeof(vertices));
-		Font::fontRenderer->DrawTriangles(6);
+			out.push_back(MakeQuad(ch, xpos, ypos, w, h));
+		}
 
 		// 移动到下一个字符位置
 		x += (ch.Advance >> 6) * scale; // 位移单位是1/64像素，所以位移6位
 	}
-
-	// 解绑或恢复由后端负责
 }
 
 
 void Font::RenderTextBetween(const std::string& text, SubRegion region, float scale, const glm::vec4& color) {
-	RenderTextBetween(string2wstring(text), region, scale, color);
+	RenderTextBetween(text, Region(region.getx(), region.gety(), region.getxend(), region.getyend(), false), scale, color);
 }
 
 void Font::RenderTextBetween(const std::wstring& text, SubRegion region, float scale,const glm::vec4& color){
@@ -160,16 +137,17 @@ void Font::RenderTextBetween(const std::wstring& text, SubRegion region, float s
 }
 
 void Font::RenderTextBetween(const std::string& text, Region region, float scale, const glm::vec4& color) {
-	std::wstring wtext=string2wstring(text);
-	RenderTextBetween(wtext, region, scale, color);
+	RenderLayout(AsBytes(text), false, LayoutMode::Between, region.getx(), region.gety(),
+		region.getxend() - region.getx(), region.getyend() - region.gety(), scale, color);
 }
 
-void Font::RenderTextBetween(const std::wstring& text, Region region, float scale_, const glm::vec4& color) {
-	float scale = CalculateDynamicScale(scale_);
-	//计算可用的区域宽度
-	float availableWidth = region.getxend() - region.getx();
-	float availableHeight = region.getyend() - region.gety();
+void Font::RenderTextBetween(const std::wstring& text, Region region, float scale, const glm::vec4& color) {
+	RenderLayout(AsBytes(text), true, LayoutMode::Between, region.getx(), region.gety(),
+		region.getxend() - region.getx(), region.getyend() - region.gety(), scale, color);
+}
 
+void Font::LayoutBetween(const std::wstring& text, float availableWidth, float availableHeight, float scale_, std::vector<LayoutQuad>& out) {
+	float scale = CalculateDynamicScale(scale_);
 	if (availableWidth <= 0 || availableHeight <= 0 || text.empty()) {
 		return; // 没有可用空间或文本为空，直接返回
 	}
@@ -180,11 +158,7 @@ void Font::RenderTextBetween(const std::wstring& text, Region region, float scal
 	
 	for (size_t i = 0; i < text.length(); ++i) {
 		wchar_t c = text[i];
-		if (!Characters.contains(c)) {
-			LoadCharacter(c);
-		}
-		
-		Character ch = Characters[c];
+		const Character& ch = ResolveGlyph(c);
 		float charWidth = (ch.Advance >> 6) * scale;
 		
 		// 检查是否超出可用宽度
@@ -200,22 +174,19 @@ void Font::RenderTextBetween(const std::wstring& text, Region region, float scal
 	// 如果displayText为空（即第一个字符就超出区域），则至少显示一个字符
 	if (displayText.empty() && !text.empty()) {
 		displayText = text.substr(0, 1);
-		if (!Characters.contains(displayText[0])) {
-			LoadCharacter(displayText[0]);
-		}
-		textWidth = (Characters[displayText[0]].Advance >> 6) * scale;
+		textWidth = (ResolveGlyph(displayText[0]).Advance >> 6) * scale;
 	}
 	
 	// 计算起始位置（水平居中）
-	float x = region.getx() + (availableWidth - textWidth) / 2.0f;
-	float y = region.gety() + (availableHeight - fontSize * scale) / 2.0f;
+	float x = (availableWidth - textWidth) / 2.0f;
+	float y = (availableHeight - fontSize * scale) / 2.0f;
 
-	// 渲染截断后的文本
-	RenderText(displayText, x, y, scale_, color);
+	// 排版截断后的文本
+	LayoutLine(displayText, x, y, scale_, out);
 }
 
 void Font::RenderTextCentered(const std::string& text, SubRegion region, float scale, const glm::vec4& color) {
-	RenderTextCentered(string2wstring(text), region, scale, color);
+	RenderTextCentered(text, Region(region.getx(), region.gety(), region.getxend(), region.getyend(), false), scale, color);
 }
 
 void Font::RenderTextCentered(const std::wstring& text, SubRegion region, float scale, const glm::vec4& color){
@@ -223,57 +194,41 @@ void Font::RenderTextCentered(const std::wstring& text, SubRegion region, float
 }
 
 void Font::RenderTextCentered(const std::string& text, Region region, float scale, const glm::vec4& color) {
-	std::wstring wtext = string2wstring(text);
-	RenderTextCentered(wtext, region, scale, color);
+	RenderLayout(AsBytes(text), false, LayoutMode::Centered, region.getx(), region.gety(),
+		region.getxend() - region.getx(), region.getyend() - region.gety(), scale, color);
 }
 
-void Font::RenderTextCentered(const std::wstring& text, Region region, float scale_, const glm::vec4& color) {
-	float scale = CalculateDynamicScale(scale_);
-	Region region_ = Region(region.getx(), region.gety(), region.getxend(), region.getyend(), false);
-	// 计算可用的区域宽度和高度
-	float availableWidth = region.getxend() - region.getx();
-	float availableHeight = region.getyend() - region.gety();
+void Font::RenderTextCentered(const std::wstring& text, Region region, float scale, const glm::vec4& color) {
+	RenderLayout(AsBytes(text), true, LayoutMode::Centered, region.getx(), region.gety(),
+		region.getxend() - region.getx(), region.getyend() - region.gety(), scale, color);
+}
 
+void Font::LayoutCentered(const std::wstring& text, float availableWidth, float availableHeight, float scale_, std::vector<LayoutQuad>& out) {
+	float scale = CalculateDynamicScale(scale_);
 	if (availableWidth <= 0 || availableHeight <= 0 || text.empty()) {
 		return; // 没有可用空间或文本为空，直接返回
 	}
 
-	// 加载所有未加载的字符
-	for (auto c = text.begin(); c != text.end(); ++c) {
-		if (!Characters.contains(*c)) {
-			LoadCharacter(*c);
-		}
-	}
-
-	// 测量完整文本的宽度
+	// 测量完整文本的宽度（同时请求未加载的字符）
 	float textWidth = 0.0f;
 	for (auto c = text.begin(); c != text.end(); ++c) {
-		Character ch = Characters[*c];
+		const Character& ch = ResolveGlyph(*c);
 		textWidth += (ch.Advance >> 6) * scale;
 	}
 	
 	// 计算起始位置（水平和垂直居中）
-	float x = region.getx() + (availableWidth - textWidth) / 2.0f;
-	float y = region.gety() + (availableHeight - fontSize * scale) / 2.0f ;
-	// 渲染完整文本（不截断）
-	RenderText(text, x, y, scale_, color);
+	float x = (availableWidth - textWidth) / 2.0f;
+	float y = (availableHeight - fontSize * scale) / 2.0f ;
+	// 排版完整文本（不截断）
+	LayoutLine(text, x, y, scale_, out);
 }
 
 void Font::RenderChar(wchar_t text, float x, float y_origin, float scale, const glm::vec4& color) {
 	scale = CalculateDynamicScale(scale);
 	float y = WindowInfo.height - y_origin - fontSize * scale;
 	//检查是否包含未加载的字符
-	if (!Characters.contains(text))
-	{
-		LoadCharacter(text);
-	}
-	// 设置正交投影矩阵并通知渲染后端
-	glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(WindowInfo.width), 0.0f, static_cast<float>(WindowInfo.height));
-	Font::fontRenderer->SetProjection(projection);
-	Font::fontRenderer->SetTextColor(glm::vec3(color.r, color.g, color.b), color.a);
-	Font::fontRenderer->PrepareForText();
-	// 遍历文本中的字符
-	Character ch = Characters[text];
+	const Character& ch = ResolveGlyph(text);
+	if (!ch.Slot.IsValid()) return;
 
 	float xpos = x + ch.Bearing.x * scale;
 	float ypos = y - (ch.Size.y - ch.Bearing.y) * scale;
@@ -281,21 +236,10 @@ void Font::RenderChar(wchar_t text, float x, float y_origin, float scale, const
 	float w = ch.Size.x * scale;
 	float h = ch.Size.y * scale;
 
-	// 更新 VBO
-	float vertices[6][4] = {
-		{ xpos,     ypos + h,   0.0f, 0.0f },
-		{ xpos,     ypos,       0.0f, 1.0f },
-		{ xpos + w, ypos,       1.0f, 1.0f },
-
-		{ xpos,     ypos + h,   0.0f, 0.0f },
-		{ xpos + w, ypos,       1.0f, 1.0f },
-		{ xpos + w, ypos + h,   1.0f, 0.0f }
-	};
-
-	// 由后端绑定纹理并绘制
-	Font::fontRenderer->BindTexture(ch.TextureID);
-	Font::fontRenderer->UpdateVertexBuffer(vertices, sizeof(vertices));
-	Font::fontRenderer->DrawTriangles(6);
+	BeginTextRun(color);
+	LayoutQuad q = MakeQuad(ch, xpos, ypos, w, h);
+	AppendQuad(q.page, q.quad);
+	EndTextRun();
 }
 
 void Font::RenderCharFitRegion(wchar_t text, Region region, const glm::vec4& color) {
@@ -308,9 +252,7 @@ void Font::RenderCharFitRegion(wchar_t text, Region region, const glm::vec4& col
 	if (xend <= x || yend <= y) return;
 
 	// 检查是否包含未加载的字符
-	if (!Characters.contains(text)) LoadCharacter(text);
-
-	Character ch = Characters[text];
+	const Character& ch = ResolveGlyph(text);
 
 	// 计算可用区域的宽度
 	float availableWidth = xend - x;
@@ -347,122 +289,460 @@ void Font::RenderCharFitRegion(wchar_t text, SubRegion region, const glm::vec4&
 
 bool Font::operator==(const Font& b) const
 {
-	if (face == b.face)return true;
+	if (this == &b)return true;
+	if (face != nullptr && face == b.face)return true;
 	return false;
 }
-static std::mutex mx;
+bool Font::EnsureFace()
+{
+	if (face) return true;
+	if (faceFailed) return false;
+	// 初始化 FreeType 字库
+	if(ft==nullptr) {
+		if (FT_Init_FreeType(&ft)) {
+			std::cerr << "无法初始化 FreeType 库" << std::endl;
+			ft = nullptr;
+			faceFailed = true;
+			return false;
+		}
+	}
+	// 加载字体
+	if (FT_New_Face(ft, fontPath.c_str(), 0, &face)) {
+		std::cerr << "无法加载字体: " << fontPath << std::endl;
+		face = nullptr;
+		faceFailed = true;
+		return false;
+	}
+	// 设置字体大小
+	FT_Set_Pixel_Sizes(face, 0, fontSize);
+	return true;
+}
+
+bool Font::CreateCharacter(const GlyphCache::Entry& glyph, Character& out)
+{
+	// 放入字形图集（交给渲染后端），空白字符没有位图，不占用图集
+	IFontRenderer::AtlasSlot slot;
+	if (Font::fontRenderer && glyph.width > 0 && glyph.height > 0) {
+		if (!Font::fontRenderer->AllocateGlyph(glyph.width, glyph.height, glyph.bitmap, slot)) {
+			// 不保存该字符，图集页解除固定后重新请求
+			Log << Level::Error << "Failed to place glyph into atlas" << op::endl;
+			atlasPlacementFailed = true;
+			return false;
+		}
+	}
+	out = Character{
+		slot,
+		glm::ivec2(glyph.width, glyph.height),
+		glm::ivec2(glyph.bearingX, glyph.bearingY),
+		glyph.advance
+	};
+	return true;
+}
+
 bool Font::LoadCharacter(wchar_t c)
 {
 	//检查是否已经加载过
-	if (Characters.contains(c))return true;
-	mx.lock();
+	if (Characters.Contains(c))return true;
+	// 优先从磁盘缓存读取，无需FreeType
+	GlyphCache::Entry cached;
+	if (glyphCache && glyphCache->Lookup(c, cached)) {
+		Character ch;
+		if (!CreateCharacter(cached, ch)) return false;
+		StoreCharacter(c, ch);
+		return true;
+	}
+	if (!EnsureFace()) {
+		return false;
+	}
 	// 加载字符字形
 	if (FT_Get_Char_Index(face,c)==0)
 	{
-		mx.unlock();
 		std::wcout << L"字符不存在: " << c << std::endl;
-		if (!spare_font)return false;
-		if (FT_Get_Char_Index(spare_font->face, c) == 0)return false;
-		Characters.insert(std::pair(c, spare_font->GetCharacter(c)));
+		if (!spare_font || spare_font.get() == this)return false;
+		if (!spare_font->LoadCharacter(c))return false;
+		StoreCharacter(c, spare_font->GetCharacter(c));
 		return true;
 	}
-	if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
-		mx.unlock();
+	if (FT_Load_Char(face, c, distanceField ? FT_LOAD_DEFAULT : FT_LOAD_RENDER) ||
+		(distanceField && FT_Render_Glyph(face->glyph, FT_RENDER_MODE_SDF))) {
 		std::wcerr << L"加载字符失败: " << c << std::endl;
 		return false;
 	}
-	// 生成纹理（交给渲染后端）
-	IFontRenderer::TextureId texId = 0;
-	if (Font::fontRenderer) {
-		texId = Font::fontRenderer->CreateGlyphTexture(
-			face->glyph->bitmap.width,
-			face->glyph->bitmap.rows,
-			face->glyph->bitmap.buffer
-		);
-	}
-	unsigned int texture = static_cast<unsigned int>(texId);
-
-	// 存储字符
-	Character character = {
-		texture,
-		glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-		glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-		static_cast<unsigned int>(face->glyph->advance.x)
-	};
-	Characters.insert(std::pair(c, character));
+	GlyphCache::Entry glyph;
+	glyph.width = static_cast<int>(face->glyph->bitmap.width);
+	glyph.height = static_cast<int>(face->glyph->bitmap.rows);
+	glyph.bearingX = face->glyph->bitmap_left;
+	glyph.bearingY = face->glyph->bitmap_top;
+	glyph.advance = static_cast<unsigned int>(face->glyph->advance.x);
+	glyph.bitmap = face->glyph->bitmap.buffer;
+
+	// 存储字符，并记录到磁盘缓存（放不进图集时也记录，重试时无需FreeType）
+	Character ch;
+	const bool placed = CreateCharacter(glyph, ch);
+	if (glyphCache) glyphCache->Store(c, glyph);
+	if (!placed) return false;
+	StoreCharacter(c, ch);
 	std::wcout << c<<L"\t";
-	mx.unlock();
 	return true;
 }
 
 unsigned int Font::GetFontSize() const
 {
-	return fontSize;
+	return requestedSize;
 }
 
-Character Font::GetCharacter(wchar_t c)
+const Character& Font::GetCharacter(wchar_t c)
 {
-	if (!Characters.contains(c))
-	{
-		if (!LoadCharacter(c))return Characters[L'?'];
+	if (!Characters.Contains(c) && !LoadCharacter(c)) return Placeholder();
+	return ResolveGlyph(c);
+}
+
+const Character& Font::ResolveGlyph(wchar_t c)
+{
+	const Character* ch = Characters.Find(c);
+	if (!ch) {
+		if (!RequestCharacter(c)) return Placeholder();
+		ch = Characters.Find(c);
+		if (!ch) return Placeholder();
+	}
+	if (IsBlank(*ch) || (ch->Slot.IsValid() && Font::fontRenderer->TouchGlyph(ch->Slot))) {
+		return *ch;
 	}
-	return Characters[c];
+	// 所在图集页已被驱逐，重新加载
+	EraseCharacter(c);
+	if (!RequestCharacter(c)) return Placeholder();
+	ch = Characters.Find(c);
+	return ch ? *ch : Placeholder();
 }
 
-void Font::RenderTextVertical(const std::string& text, float x, float y, float scale, const glm::vec4& color) {
-	std::wstring wtext = string2wstring(text);
-	RenderTextVertical(wtext, x, y, scale, color);
+const Character& Font::Placeholder()
+{
+	static const Character empty{};
+	const Character* ch = Characters.Find(L'?');
+	if (ch && (IsBlank(*ch) || (ch->Slot.IsValid() && Font::fontRenderer->TouchGlyph(ch->Slot)))) {
+		return *ch;
+	}
+	// 占位字形同步加载，保证始终可用
+	if (ch) EraseCharacter(L'?');
+	if (!LoadCharacter(L'?')) return empty;
+	ch = Characters.Find(L'?');
+	return ch ? *ch : empty;
 }
 
-void Font::RenderTextVertical(const std::wstring& text, float x, float y_origin, float scale, const glm::vec4& color) {
-	scale = CalculateDynamicScale(scale);
-	float y = WindowInfo.height - y_origin - fontSize * scale;
-	//检查是否包含未加载的字符
-	for (auto c = text.begin(); c != text.end(); ++c) {
-		if (!Characters.contains(*c)) {
-			LoadCharacter(*c);
-		}
+bool Font::RequestCharacter(wchar_t c)
+{
+	// 磁盘缓存命中：直接放入图集
+	GlyphCache::Entry cached;
+	if (glyphCache && glyphCache->Lookup(c, cached)) {
+		Character ch;
+		if (!CreateCharacter(cached, ch)) return false;
+		StoreCharacter(c, ch);
+		return true;
+	}
+	// 字体中不存在的字符使用备用字体
+	if (missingGlyphs.contains(c)) return CopyFromSpare(c);
+	if (!asyncRasterization) return LoadCharacter(c);
+	// 交给后台线程光栅化，到达之前绘制占位字形
+	if (pendingGlyphs.insert(c).second) {
+		GlyphRasterizer::Get().Enqueue({fontId, fontPath, fontSize, c, distanceField});
 	}
-	// 设置正交投影矩阵并通知渲染后端
+	return false;
+}
+
+bool Font::CopyFromSpare(wchar_t c)
+{
+	if (!spare_font || spare_font.get() == this) return false;
+	const Character& ch = spare_font->ResolveGlyph(c);
+	// 备用字体可能仍在后台加载该字符
+	if (!spare_font->Characters.Contains(c)) return false;
+	StoreCharacter(c, ch);
+	return true;
+}
+
+void Font::OnGlyphRasterized(const GlyphRasterizer::Result& result)
+{
+	const wchar_t c = result.codepoint;
+	pendingGlyphs.erase(c);
+	if (Characters.Contains(c)) return;
+	if (result.missing || result.failed) {
+		if (result.failed) Log << Level::Warn << "Failed to rasterize glyph " << static_cast<int>(c) << op::endl;
+		missingGlyphs.insert(c);
+		// 已缓存的排版中该字符是占位字形；备用字体尚未就绪时也要重新排版
+		if (!CopyFromSpare(c)) glyphEpoch++;
+		return;
+	}
+	GlyphCache::Entry glyph = result.metrics;
+	glyph.bitmap = result.bitmap.data();
+	if (glyphCache) glyphCache->Store(c, glyph);
+	Character ch;
+	if (!CreateCharacter(glyph, ch)) {
+		// 已缓存的排版中该字符是占位字形，使其失效以便重新请求
+		glyphEpoch++;
+		return;
+	}
+	StoreCharacter(c, ch);
+}
+
+void Font::ProcessRasterizedGlyphs()
+{
+	// 取出后台完成的结果，追加到待上传队列
+	GlyphRasterizer::Result* list = GlyphRasterizer::Get().TakeCompleted();
+	while (list) {
+		GlyphRasterizer::Result* next = list->next;
+		list->next = nullptr;
+		uploadBacklog.emplace_back(list);
+		list = next;
+	}
+	// 每帧按预算上传，至少上传一个
+	size_t uploadedBytes = 0;
+	size_t uploaded = 0;
+	while (!uploadBacklog.empty() && (uploaded == 0 || uploadedBytes < uploadBudgetBytes)) {
+		std::unique_ptr<GlyphRasterizer::Result> result = std::move(uploadBacklog.front());
+		uploadBacklog.pop_front();
+		auto it = registry.find(result->fontId);
+		if (it == registry.end()) continue; // 字体已销毁
+		it->second->OnGlyphRasterized(*result);
+		uploadedBytes += result->bitmap.size();
+		uploaded++;
+	}
+}
+
+void Font::ResolveRun(const std::wstring& text)
+{
+	runGlyphs.clear();
+	runGlyphs.reserve(text.size());
+	for (wchar_t c : text) {
+		runGlyphs.push_back(ResolveGlyph(c));
+	}
+}
+
+void Font::BeginTextRun(const glm::vec4& color)
+{
+	// 设置正交投影矩阵（后端只在变化时更新）
 	glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(WindowInfo.width), 0.0f, static_cast<float>(WindowInfo.height));
 	Font::fontRenderer->SetProjection(projection);
 	Font::fontRenderer->SetTextColor(glm::vec3(color.r, color.g, color.b), color.a);
+	Font::fontRenderer->SetDistanceField(distanceField);
 	Font::fontRenderer->PrepareForText();
-	float current_y = y;
-	// 垂直方向从上到下渲染文本
-	for (auto c = text.begin(); c != text.end(); ++c) {
-		Character ch = Characters[*c];
+	runQuads.clear();
+	runPage = IFontRenderer::AtlasSlot::InvalidPage;
+}
 
-		float xpos = x + ch.Bearing.x * scale;
-		float ypos = current_y - (ch.Size.y - ch.Bearing.y) * scale;
+Font::LayoutQuad Font::MakeQuad(const Character& ch, float xpos, float ypos, float w, float h)
+{
+	const glm::vec4& uv = ch.Slot.uv;
+	return LayoutQuad{ ch.Slot.page, ch.Slot.generation, { xpos, ypos, xpos + w, ypos + h, uv.x, uv.y, uv.z, uv.w } };
+}
 
-		float w = ch.Size.x * scale;
-		float h = ch.Size.y * scale;
+void Font::AppendQuad(uint32_t page, const IFontRenderer::GlyphQuad& quad)
+{
+	// 图集页变化时先提交已有的四边形
+	if (page != runPage) {
+		EndTextRun();
+		runPage = page;
+	}
+	runQuads.push_back(quad);
+}
+
+void Font::EndTextRun()
+{
+	if (!runQuads.empty()) {
+		Font::fontRenderer->SubmitQuads(runQuads, runPage);
+		runQuads.clear();
+	}
+}
 
-		// 更新 VBO
-		float vertices[6][4] = {
-			{ xpos,     ypos + h,   0.0f, 0.0f },
-			{ xpos,     ypos,       0.0f, 1.0f },
-			{ xpos + w, ypos,       1.0f, 1.0f },
+namespace {
+constexpr uint64_t kFnvOffset = 1469598103934665603ull;
+constexpr uint64_t kFnvPrime = 1099511628211ull;
+constexpr size_t kMaxCachedLayouts = 512;
 
-			{ xpos,     ypos + h,   0.0f, 0.0f },
-			{ xpos + w, ypos,       1.0f, 1.0f },
-			{ xpos + w, ypos + h,   1.0f, 0.0f }
-		};
+uint64_t HashBytes(const void* data, size_t size, uint64_t hash)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= bytes[i];
+		hash *= kFnvPrime;
+	}
+	return hash;
+}
 
-	// 由后端绑定纹理并绘制
-	Font::fontRenderer->BindTexture(ch.TextureID);
-	Font::fontRenderer->UpdateVertexBuffer(vertices, sizeof(vertices));
-	Font::fontRenderer->DrawTriangles(6);
+template <typename T>
+uint64_t HashValue(uint64_t hash, const T& value)
+{
+	return HashBytes(&value, sizeof(value), hash);
+}
+}
 
-	// 移动到下一个字符位置（向下移动）
-	current_y -= ch.Size.y * scale * 1.2f; // 添加一点额外间距
+void Font::StoreCharacter(wchar_t c, const Character& ch)
+{
+	Characters.InsertOrAssign(c, ch);
+	glyphEpoch++;
+	// 备用字体加载了新字符：缺少该字符的字体此前排版时用的是占位字形，使其排版失效
+	if (spare_font.get() == this) {
+		for (auto& [id, font] : registry) {
+			if (font != this && font->missingGlyphs.contains(c)) {
+				font->glyphEpoch++;
+			}
+		}
 	}
+}
+
+void Font::EraseCharacter(wchar_t c)
+{
+	Characters.Erase(c);
+	glyphEpoch++;
+}
 
+void Font::BuildLayout(const std::wstring& text, LayoutMode mode, float scale, float width, float height, std::vector<LayoutQuad>& out)
+{
+	switch (mode) {
+	case LayoutMode::Line:            LayoutLine(text, 0.0f, 0.0f, scale, out); break;
+	case LayoutMode::Vertical:        LayoutVertical(text, 0.0f, 0.0f, scale, out); break;
+	case LayoutMode::Between:         LayoutBetween(text, width, height, scale, out); break;
+	case LayoutMode::Centered:        LayoutCentered(text, width, height, scale, out); break;
+	case LayoutMode::VerticalBetween: LayoutVerticalBetween(text, width, height, scale, out); break;
+	case LayoutMode::FitRegion:       LayoutFitRegion(text, width, height, out); break;
+	}
+}
+
+const Font::TextLayout& Font::GetLayout(std::string_view bytes, bool wide, LayoutMode mode, float scale, float width, float height)
+{
+	// 窗口尺寸变化会改变动态缩放，所有排版失效
+	if (WindowInfo.width != layoutWindowWidth || WindowInfo.height != layoutWindowHeight) {
+		layoutCache.clear();
+		layoutWindowWidth = WindowInfo.width;
+		layoutWindowHeight = WindowInfo.height;
+	}
+
+	// 直接对原始字节求哈希，命中时不需要转换编码
+	uint64_t hash = HashBytes(bytes.data(), bytes.size(), kFnvOffset);
+	hash = HashValue(hash, static_cast<uint8_t>(mode) | (wide ? 0x80u : 0u));
+	hash = HashValue(hash, scale);
+	hash = HashValue(hash, width);
+	hash = HashValue(hash, height);
+
+	auto it = layoutCache.find(hash);
+	if (it != layoutCache.end()) {
+		TextLayout& layout = it->second;
+		if (layout.epoch == glyphEpoch && layout.mode == mode && layout.wide == wide &&
+			layout.scale == scale && layout.width == width && layout.height == height &&
+			layout.key == bytes && LayoutResident(layout)) {
+			return layout;
+		}
+	} else {
+		if (layoutCache.size() >= kMaxCachedLayouts) {
+			layoutCache.clear();
+		}
+		it = layoutCache.emplace(hash, TextLayout{}).first;
+	}
+
+	// 未命中或已失效：重新排版
+	TextLayout& layout = it->second;
+	layout.key.assign(bytes.data(), bytes.size());
+	layout.mode = mode;
+	layout.wide = wide;
+	layout.scale = scale;
+	layout.width = width;
+	layout.height = height;
+	layout.quads.clear();
+	layout.pages.clear();
+
+	std::wstring text;
+	if (wide) {
+		text.resize(bytes.size() / sizeof(wchar_t));
+		std::memcpy(text.data(), bytes.data(), text.size() * sizeof(wchar_t));
+	} else {
+		text = string2wstring(layout.key);
+	}
+	// 排版期间固定已用到的图集页：后面的字形加载时驱逐前面字形所在的页，会使已生成的四边形失效
+	Font::fontRenderer->BeginAtlasPin();
+	atlasPlacementFailed = false;
+	BuildLayout(text, mode, scale, width, height, layout.quads);
+	Font::fontRenderer->EndAtlasPin();
+	layout.epoch = glyphEpoch;
+	// 有字形因图集页全被固定而用了占位字形（可能来自备用字体）：下次使用时重新排版
+	if (atlasPlacementFailed) glyphEpoch++;
+
+	// 记录引用的图集页，用于检测驱逐
+	for (const LayoutQuad& q : layout.quads) {
+		bool known = false;
+		for (const auto& slot : layout.pages) {
+			if (slot.page == q.page) { known = true; break; }
+		}
+		if (!known) {
+			IFontRenderer::AtlasSlot slot;
+			slot.page = q.page;
+			slot.generation = q.generation;
+			layout.pages.push_back(slot);
+		}
+	}
+	return layout;
+}
+
+bool Font::LayoutResident(const TextLayout& layout) const
+{
+	// 同时刷新图集页的LRU记录
+	for (const auto& slot : layout.pages) {
+		if (!Font::fontRenderer->TouchGlyph(slot)) return false;
+	}
+	return true;
+}
+
+void Font::RenderLayout(std::string_view bytes, bool wide, LayoutMode mode, float x, float y, float width, float height, float scale, const glm::vec4& color)
+{
+	if (bytes.empty()) return;
+	PROFILE_SCOPE("text render");
+	const TextLayout& layout = GetLayout(bytes, wide, mode, scale, width, height);
+	if (layout.quads.empty()) return;
+
+	// 排版以区域左上角为原点；屏幕坐标y向下，投影坐标y向上
+	BeginTextRun(color);
+	for (const LayoutQuad& q : layout.quads) {
+		IFontRenderer::GlyphQuad quad = q.quad;
+		quad.x0 += x;
+		quad.x1 += x;
+		quad.y0 -= y;
+		quad.y1 -= y;
+		AppendQuad(q.page, quad);
+	}
+	EndTextRun();
+}
+
+void Font::RenderTextVertical(const std::string& text, float x, float y, float scale, const glm::vec4& color) {
+	RenderLayout(AsBytes(text), false, LayoutMode::Vertical, x, y, 0.0f, 0.0f, scale, color);
+}
+
+void Font::RenderTextVertical(const std::wstring& text, float x, float y, float scale, const glm::vec4& color) {
+	RenderLayout(AsBytes(text), true, LayoutMode::Vertical, x, y, 0.0f, 0.0f, scale, color);
+}
+
+void Font::LayoutVertical(const std::wstring& text, float x, float y_origin, float scale, std::vector<LayoutQuad>& out) {
+	scale = CalculateDynamicScale(scale);
+	float y = WindowInfo.height - y_origin - fontSize * scale;
+	// 先解析全部字形（按需加载），再统一排版
+	ResolveRun(text);
+
+	float current_y = y;
+	// 垂直方向从上到下渲染文本
+	for (const Character& ch : runGlyphs) {
+		if (ch.Slot.IsValid()) {
+			float xpos = x + ch.Bearing.x * scale;
+			float ypos = current_y - (ch.Size.y - ch.Bearing.y) * scale;
+
+			float w = ch.Size.x * scale;
+			float h = ch.Size.y * scale;
+
+			out.push_back(MakeQuad(ch, xpos, ypos, w, h));
+		}
+
+		// 移动到下一个字符位置（向下移动）
+		current_y -= ch.Size.y * scale * 1.2f; // 添加一点额外间距
+	}
 }
 
 void Font::RenderTextVerticalBetween(const std::string& text, SubRegion region, float scale, const glm::vec4& color) {
-	RenderTextVerticalBetween(string2wstring(text), region, scale, color);
+	RenderTextVerticalBetween(text, Region(region.getx(), region.gety(), region.getxend(), region.getyend(), false), scale, color);
 }
 
 void Font::RenderTextVerticalBetween(const std::wstring& text, SubRegion region, float scale, const glm::vec4& color) {
@@ -470,16 +750,17 @@ void Font::RenderTextVerticalBetween(const std::wstring& text, SubRegion region,
 }
 
 void Font::RenderTextVerticalBetween(const std::string& text, Region region, float scale, const glm::vec4& color) {
-	std::wstring wtext = string2wstring(text);
-	RenderTextVerticalBetween(wtext, region, scale, color);
+	RenderLayout(AsBytes(text), false, LayoutMode::VerticalBetween, region.getx(), region.gety(),
+		region.getxend() - region.getx(), region.getyend() - region.gety(), scale, color);
 }
 
-void Font::RenderTextVerticalBetween(const std::wstring& text, Region region, float scale_, const glm::vec4& color) {
-	float scale = CalculateDynamicScale(scale_);
+void Font::RenderTextVerticalBetween(const std::wstring& text, Region region, float scale, const glm::vec4& color) {
+	RenderLayout(AsBytes(text), true, LayoutMode::VerticalBetween, region.getx(), region.gety(),
+		region.getxend() - region.getx(), region.getyend() - region.gety(), scale, color);
+}
 
-	//计算可用的区域高度
-	float availableWidth = region.getxend() - region.getx();
-	float availableHeight = region.getyend() - region.gety();
+void Font::LayoutVerticalBetween(const std::wstring& text, float availableWidth, float availableHeight, float scale_, std::vector<LayoutQuad>& out) {
+	float scale = CalculateDynamicScale(scale_);
 
 	if (availableWidth <= 0 || availableHeight <= 0 || text.empty()) {
 		return; // 没有可用空间或文本为空，直接返回
@@ -491,11 +772,7 @@ void Font::RenderTextVerticalBetween(const std::wstring& text, Region region, fl
 	
 	for (size_t i = 0; i < text.length(); ++i) {
 		wchar_t c = text[i];
-		if (!Characters.contains(c)) {
-			LoadCharacter(c);
-		}
-		
-		Character ch = Characters[c];
+		const Character& ch = ResolveGlyph(c);
 		float charHeight = ch.Size.y * scale * 1.2f; // 添加一点额外间距
 		
 		// 检查是否超出可用高度
@@ -511,18 +788,15 @@ void Font::RenderTextVerticalBetween(const std::wstring& text, Region region, fl
 	// 如果displayText为空（即第一个字符就超出区域），则至少显示一个字符
 	if (displayText.empty() && !text.empty()) {
 		displayText = text.substr(0, 1);
-		if (!Characters.contains(displayText[0])) {
-			LoadCharacter(displayText[0]);
-		}
-		textHeight = Characters[displayText[0]].Size.y * scale * 1.2f;
+		textHeight = ResolveGlyph(displayText[0]).Size.y * scale * 1.2f;
 	}
 	
 	// 计算起始位置（垂直居中）
-	float x = region.getx() + (availableWidth - fontSize * scale) / 2.0f;
-	float y = region.gety() + (availableHeight - textHeight) / 2.0f;
+	float x = (availableWidth - fontSize * scale) / 2.0f;
+	float y = (availableHeight - textHeight) / 2.0f;
 	
-	// 渲染截断后的垂直文本
-	RenderTextVertical(displayText, x, y, scale_, color);
+	// 排版截断后的垂直文本
+	LayoutVertical(displayText, x, y, scale_, out);
 }
 
 // 添加一个计算动态缩放因子的私有方法
@@ -542,8 +816,8 @@ float Font::CalculateDynamicScale(float baseScale) const {
     // 使用较小的比例以确保在任何方向上都不会太大
     float scaleFactor = std::min(widthRatio, heightRatio);
     
-    // 应用用户提供的基础缩放并返回
-    return baseScale * scaleFactor;
+    // 应用用户提供的基础缩放并返回（距离场字体还需换算到光栅化大小）
+    return baseScale * scaleFactor * sizeFactor;
 }
 
 float Font::DeCalculateDynamicScale(float scaledValue) const {
@@ -563,36 +837,28 @@ float Font::DeCalculateDynamicScale(float scaledValue) const {
     float scaleFactor = std::min(widthRatio, heightRatio);
 
     // 反向应用缩放因子
-    return scaledValue / scaleFactor;
+    return scaledValue / (scaleFactor * sizeFactor);
 }
 
 void Font::RenderStringFitRegion(const std::string& text, Region region, const glm::vec4& color) {
-	RenderStringFitRegion(string2wstring(text), region, color);
+	RenderLayout(AsBytes(text), false, LayoutMode::FitRegion, region.getx(), region.gety(),
+		region.getxend() - region.getx(), region.getyend() - region.gety(), 1.0f, color);
 }
 
 void Font::RenderStringFitRegion(const std::wstring& text, Region region, const glm::vec4& color) {
-	float x = region.getx();
-	float y = region.gety();
-	float xend = region.getxend();
-	float yend = region.getyend();
+	RenderLayout(AsBytes(text), true, LayoutMode::FitRegion, region.getx(), region.gety(),
+		region.getxend() - region.getx(), region.getyend() - region.gety(), 1.0f, color);
+}
 
+void Font::LayoutFitRegion(const std::wstring& text, float availableWidth, float availableHeight, std::vector<LayoutQuad>& out) {
 	// 校验区域
-	if (xend <= x || yend <= y) return;
 	if (text.empty()) return;
-
-	// 确保字符已加载
-	for (auto c = text.begin(); c != text.end(); ++c) {
-		if (!Characters.contains(*c)) LoadCharacter(*c);
-	}
-
-	float availableWidth = xend - x;
-	float availableHeight = yend - y;
 	if (availableWidth <= 0 || availableHeight <= 0) return;
 
 	// 计算原始文本宽度
 	float textWidth = 0.0f;
 	for (auto c = text.begin(); c != text.end(); ++c) {
-		Character ch = Characters[*c];
+		const Character& ch = ResolveGlyph(*c);
 		textWidth += static_cast<float>(ch.Advance >> 6);
 	}
 	if (textWidth <= 0.0f) return;
@@ -609,10 +875,10 @@ void Font::RenderStringFitRegion(const std::wstring& text, Region region, const
 	float scaledFontHeight = static_cast<float>(fontSize) * scaleUsed;
 	float scaledTextWidth = textWidth * scaleUsed;
 
-	float x_pos = x + (availableWidth - scaledTextWidth) / 2.0f;
-	float y_pos = y + (availableHeight - scaledFontHeight) / 2.0f;
+	float x_pos = (availableWidth - scaledTextWidth) / 2.0f;
+	float y_pos = (availableHeight - scaledFontHeight) / 2.0f;
 
-	RenderText(text, x_pos, y_pos, baseScale, color);
+	LayoutLine(text, x_pos, y_pos, baseScale, out);
 }
 
 void Font::RenderStringFitRegion(const std::wstring& text, SubRegion region, const glm::vec4& color) {
@@ -620,5 +886,5 @@ void Font::RenderStringFitRegion(const std::wstring& text, SubRegion region, con
 }
 
 void Font::RenderStringFitRegion(const std::string& text, SubRegion region, const glm::vec4& color) {
-	RenderStringFitRegion(string2wstring(text), Region(region.getx(), region.gety(), region.getxend(), region.getyend(), false), color);
+	RenderStringFitRegion(text, Region(region.getx(), region.gety(), region.getxend(), region.getyend(), false), color);
 }
\ No newline at end of file
@@ -0,0 +1,359 @@
+#include "core/baseItem/GlyphCache.h"
+#include "core/log.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <mutex>
+#include <unordered_map>
+
+#ifdef _WIN32
+#undef APIENTRY
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace core;
+
+namespace {
+constexpr char kMagic[4] = { 'P', 'W', 'G', 'C' };
+constexpr uint32_t kVersion = 1;
+
+// 字体文件的标识：大小或修改时间变化时重新计算哈希
+struct FontStamp {
+	uint64_t hash = 0;
+	uint64_t size = 0;
+	int64_t mtime = 0;
+};
+
+struct FontIndex {
+	std::mutex mutex;
+	bool loaded = false;
+	std::unordered_map<std::string, FontStamp> stamps;
+};
+
+FontIndex& Fonts() {
+	static FontIndex index;
+	return index;
+}
+
+void LoadFontIndex(FontIndex& index) {
+	index.loaded = true;
+	std::ifstream in(GlyphCache::FontIndexFile);
+	std::string line;
+	while (std::getline(in, line)) {
+		std::istringstream fields(line);
+		FontStamp stamp;
+		std::string path;
+		fields >> std::hex >> stamp.hash >> std::dec >> stamp.size >> stamp.mtime;
+		fields.get(); // 分隔路径的空格
+		std::getline(fields, path);
+		if (fields.fail() || path.empty() || stamp.hash == 0) continue;
+		index.stamps[path] = stamp;
+	}
+}
+
+void SaveFontIndex(const FontIndex& index) {
+	std::error_code ec;
+	std::filesystem::create_directories(GlyphCache::CacheDirectory, ec);
+	const std::string tempPath = std::string(GlyphCache::FontIndexFile) + ".tmp";
+	{
+		std::ofstream out(tempPath, std::ios::trunc);
+		for (const auto& [path, stamp] : index.stamps) {
+			out << std::hex << stamp.hash << std::dec << ' ' << stamp.size << ' ' << stamp.mtime << ' ' << path << '\n';
+		}
+		if (!out) {
+			out.close();
+			std::filesystem::remove(tempPath, ec);
+			return;
+		}
+	}
+	std::filesystem::rename(tempPath, GlyphCache::FontIndexFile, ec);
+	if (ec) std::filesystem::remove(tempPath, ec);
+}
+}
+
+uint64_t GlyphCache::HashFile(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file) return 0;
+	uint64_t hash = 1469598103934665603ull;
+	std::vector<char> buffer(1 << 16);
+	while (file) {
+		file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		std::streamsize n = file.gcount();
+		for (std::streamsize i = 0; i < n; ++i) {
+			hash ^= static_cast<unsigned char>(buffer[i]);
+			hash *= 1099511628211ull;
+		}
+	}
+	return hash;
+}
+
+uint64_t GlyphCache::FontHash(const std::string& path)
+{
+	std::error_code ec;
+	const auto size = std::filesystem::file_size(path, ec);
+	if (ec) return 0;
+	const auto mtime = std::filesystem::last_write_time(path, ec);
+	if (ec) return 0;
+	FontStamp current;
+	current.size = static_cast<uint64_t>(size);
+	current.mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+
+	FontIndex& index = Fonts();
+	std::lock_guard<std::mutex> lock(index.mutex);
+	if (!index.loaded) LoadFontIndex(index);
+	auto it = index.stamps.find(path);
+	if (it != index.stamps.end() && it->second.size == current.size && it->second.mtime == current.mtime) {
+		return it->second.hash;
+	}
+	// 首次遇到或文件已改变：读取整个文件
+	current.hash = HashFile(path);
+	if (current.hash == 0) return 0;
+	index.stamps[path] = current;
+	SaveFontIndex(index);
+	return current.hash;
+}
+
+GlyphCache::GlyphCache(const std::string& fontPath, unsigned int pixelSize, bool distanceField)
+	: pixelSize(pixelSize)
+{
+	fontHash = FontHash(fontPath);
+	if (fontHash == 0) {
+		Log << Level::Warn << "GlyphCache: cannot hash font file " << fontPath << op::endl;
+		return;
+	}
+	std::ostringstream name;
+	name << CacheDirectory << "/" << std::hex << std::setw(16) << std::setfill('0') << fontHash
+		<< "_" << std::dec << pixelSize << (distanceField ? "_sdf" : "") << ".bin";
+	cachePath = name.str();
+
+	if (Map()) {
+		Log << Level::Info << "GlyphCache: mapped " << mappedCount << " glyphs from " << cachePath << op::endl;
+	}
+}
+
+GlyphCache::~GlyphCache()
+{
+	if (!pending.empty()) {
+		Save();
+	}
+	Unmap();
+}
+
+bool GlyphCache::Map()
+{
+	std::error_code ec;
+	if (!std::filesystem::exists(cachePath, ec)) return false;
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(cachePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return false;
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(FileHeader))) {
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping) {
+		CloseHandle(file);
+		return false;
+	}
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!view) {
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+	fileHandle = file;
+	mappingHandle = mapping;
+	mapped = static_cast<const unsigned char*>(view);
+	mappedSize = static_cast<size_t>(size.QuadPart);
+#else
+	int fd = open(cachePath.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(FileHeader))) {
+		close(fd);
+		return false;
+	}
+	void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (view == MAP_FAILED) return false;
+	mapped = static_cast<const unsigned char*>(view);
+	mappedSize = static_cast<size_t>(st.st_size);
+#endif
+
+	// 校验文件头与索引范围
+	FileHeader header;
+	std::memcpy(&header, mapped, sizeof(header));
+	size_t indexBytes = static_cast<size_t>(header.count) * sizeof(IndexEntry);
+	if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+		header.fontHash != fontHash || header.pixelSize != pixelSize ||
+		sizeof(FileHeader) + indexBytes > mappedSize) {
+		Log << Level::Warn << "GlyphCache: ignoring stale or corrupt cache " << cachePath << op::endl;
+		Unmap();
+		return false;
+	}
+	index = reinterpret_cast<const IndexEntry*>(mapped + sizeof(FileHeader));
+	blob = mapped + sizeof(FileHeader) + indexBytes;
+	mappedCount = header.count;
+	return true;
+}
+
+void GlyphCache::Unmap()
+{
+	if (mapped) {
+#ifdef _WIN32
+		UnmapViewOfFile(mapped);
+		if (mappingHandle) CloseHandle(static_cast<HANDLE>(mappingHandle));
+		if (fileHandle) CloseHandle(static_cast<HANDLE>(fileHandle));
+		mappingHandle = nullptr;
+		fileHandle = nullptr;
+#else
+		munmap(const_cast<unsigned char*>(mapped), mappedSize);
+#endif
+	}
+	mapped = nullptr;
+	mappedSize = 0;
+	index = nullptr;
+	blob = nullptr;
+	mappedCount = 0;
+}
+
+bool GlyphCache::Lookup(wchar_t c, Entry& out) const
+{
+	const uint32_t code = static_cast<uint32_t>(c);
+	auto it = pending.find(code);
+	if (it != pending.end()) {
+		out = it->second.metrics;
+		out.bitmap = it->second.bitmap.data();
+		return true;
+	}
+	if (!index) return false;
+
+	// 索引按码点升序排列
+	const IndexEntry* end = index + mappedCount;
+	const IndexEntry* found = std::lower_bound(index, end, code,
+		[](const IndexEntry& e, uint32_t value) { return e.codepoint < value; });
+	if (found == end || found->codepoint != code) return false;
+
+	size_t bytes = static_cast<size_t>(found->width) * found->height;
+	if (blob + found->offset + bytes > mapped + mappedSize) return false;
+	out.width = found->width;
+	out.height = found->height;
+	out.bearingX = found->bearingX;
+	out.bearingY = found->bearingY;
+	out.advance = found->advance;
+	out.bitmap = blob + found->offset;
+	return true;
+}
+
+void GlyphCache::Store(wchar_t c, const Entry& entry)
+{
+	if (!IsValid()) return;
+	PendingGlyph glyph;
+	glyph.metrics = entry;
+	glyph.metrics.bitmap = nullptr;
+	size_t bytes = static_cast<size_t>(entry.width) * entry.height;
+	if (entry.bitmap && bytes > 0) {
+		glyph.bitmap.assign(entry.bitmap, entry.bitmap + bytes);
+	} else {
+		glyph.metrics.width = 0;
+		glyph.metrics.height = 0;
+	}
+	pending[static_cast<uint32_t>(c)] = std::move(glyph);
+}
+
+bool GlyphCache::Save()
+{
+	if (!IsValid() || pending.empty()) return true;
+
+	// 合并映射中的旧字形与新增字形，按码点排序
+	std::vector<IndexEntry> entries;
+	std::vector<unsigned char> data;
+	entries.reserve(mappedCount + pending.size());
+	auto pendingIt = pending.begin();
+	auto append = [&](uint32_t code, const Entry& e, const unsigned char* bitmap) {
+		IndexEntry ie;
+		ie.codepoint = code;
+		ie.width = static_cast<int16_t>(e.width);
+		ie.height = static_cast<int16_t>(e.height);
+		ie.bearingX = static_cast<int16_t>(e.bearingX);
+		ie.bearingY = static_cast<int16_t>(e.bearingY);
+		ie.advance = e.advance;
+		ie.offset = static_cast<uint32_t>(data.size());
+		size_t bytes = static_cast<size_t>(e.width) * e.height;
+		if (bitmap && bytes > 0) data.insert(data.end(), bitmap, bitmap + bytes);
+		entries.push_back(ie);
+	};
+	for (size_t i = 0; i < mappedCount; ++i) {
+		const IndexEntry& old = index[i];
+		while (pendingIt != pending.end() && pendingIt->first < old.codepoint) {
+			append(pendingIt->first, pendingIt->second.metrics, pendingIt->second.bitmap.data());
+			++pendingIt;
+		}
+		if (pendingIt != pending.end() && pendingIt->first == old.codepoint) continue;
+		if (blob + old.offset + static_cast<size_t>(old.width) * old.height > mapped + mappedSize) continue;
+		Entry e;
+		e.width = old.width;
+		e.height = old.height;
+		e.bearingX = old.bearingX;
+		e.bearingY = old.bearingY;
+		e.advance = old.advance;
+		append(old.codepoint, e, blob + old.offset);
+	}
+	for (; pendingIt != pending.end(); ++pendingIt) {
+		append(pendingIt->first, pendingIt->second.metrics, pendingIt->second.bitmap.data());
+	}
+
+	FileHeader header;
+	std::memcpy(header.magic, kMagic, sizeof(kMagic));
+	header.version = kVersion;
+	header.fontHash = fontHash;
+	header.pixelSize = pixelSize;
+	header.count = static_cast<uint32_t>(entries.size());
+
+	std::error_code ec;
+	std::filesystem::create_directories(CacheDirectory, ec);
+	std::string tempPath = cachePath + ".tmp";
+	{
+		std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+		if (!out) {
+			Log << Level::Warn << "GlyphCache: cannot write " << tempPath << op::endl;
+			return false;
+		}
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(IndexEntry)));
+		out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		if (!out) {
+			Log << Level::Warn << "GlyphCache: failed writing " << tempPath << op::endl;
+			out.close();
+			std::filesystem::remove(tempPath, ec);
+			return false;
+		}
+	}
+
+	// 替换前解除映射（Windows 下无法覆盖已映射的文件）
+	Unmap();
+	std::filesystem::rename(tempPath, cachePath, ec);
+	if (ec) {
+		Log << Level::Warn << "GlyphCache: cannot replace " << cachePath << ": " << ec.message() << op::endl;
+		std::filesystem::remove(tempPath, ec);
+		Map();
+		return false;
+	}
+	pending.clear();
+	Map();
+	Log << Level::Info << "GlyphCache: saved " << entries.size() << " glyphs to " << cachePath << op::endl;
+	return true;
+}
@@ -0,0 +1,153 @@
+#include "core/baseItem/GlyphRasterizer.h"
+#include "core/log.h"
+#include "core/render/DamageTracker.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <utility>
+#include <freetype/freetype.h>
+#include FT_FREETYPE_H
+
+using namespace core;
+
+GlyphRasterizer& GlyphRasterizer::Get()
+{
+	static GlyphRasterizer instance;
+	return instance;
+}
+
+GlyphRasterizer::GlyphRasterizer()
+{
+	// 给渲染线程留出一个核心
+	unsigned int hw = std::thread::hardware_concurrency();
+	unsigned int count = std::clamp(hw > 1 ? hw - 1 : 1u, 1u, 4u);
+	for (unsigned int i = 0; i < count; ++i) {
+		workers.emplace_back(&GlyphRasterizer::WorkerLoop, this);
+	}
+	Log << Level::Info << "GlyphRasterizer started " << count << " worker threads" << op::endl;
+}
+
+GlyphRasterizer::~GlyphRasterizer()
+{
+	{
+		std::lock_guard<std::mutex> lock(requestMutex);
+		stopping = true;
+		requests.clear();
+	}
+	requestCv.notify_all();
+	for (auto& worker : workers) {
+		if (worker.joinable()) worker.join();
+	}
+	Result* list = TakeCompleted();
+	while (list) {
+		Result* next = list->next;
+		delete list;
+		list = next;
+	}
+}
+
+void GlyphRasterizer::Enqueue(Request request)
+{
+	{
+		std::lock_guard<std::mutex> lock(requestMutex);
+		requests.push_back(std::move(request));
+	}
+	requestCv.notify_one();
+}
+
+void GlyphRasterizer::PushCompleted(Result* result)
+{
+	result->next = completed.load(std::memory_order_relaxed);
+	while (!completed.compare_exchange_weak(result->next, result,
+		std::memory_order_release, std::memory_order_relaxed)) {
+	}
+	// 缺字的文字需要在字形上传后重绘
+	DamageTracker::Get().Invalidate();
+}
+
+GlyphRasterizer::Result* GlyphRasterizer::TakeCompleted()
+{
+	Result* list = completed.exchange(nullptr, std::memory_order_acquire);
+	// 栈为后进先出，反转成完成顺序
+	Result* ordered = nullptr;
+	while (list) {
+		Result* next = list->next;
+		list->next = ordered;
+		ordered = list;
+		list = next;
+	}
+	return ordered;
+}
+
+void GlyphRasterizer::WorkerLoop()
+{
+	// 线程私有的 FreeType 实例，不与其他线程共享
+	FT_Library library = nullptr;
+	if (FT_Init_FreeType(&library)) {
+		Log << Level::Error << "GlyphRasterizer: FT_Init_FreeType failed" << op::endl;
+		library = nullptr;
+	}
+	std::map<std::pair<std::string, unsigned int>, FT_Face> faces;
+
+	while (true) {
+		Request request;
+		{
+			std::unique_lock<std::mutex> lock(requestMutex);
+			requestCv.wait(lock, [this] { return stopping || !requests.empty(); });
+			if (stopping) break;
+			request = std::move(requests.front());
+			requests.pop_front();
+		}
+
+		Result* result = new Result;
+		result->fontId = request.fontId;
+		result->codepoint = request.codepoint;
+
+		FT_Face face = nullptr;
+		auto key = std::make_pair(request.fontPath, request.pixelSize);
+		auto it = faces.find(key);
+		if (it != faces.end()) {
+			face = it->second;
+		} else if (library) {
+			if (FT_New_Face(library, request.fontPath.c_str(), 0, &face) == 0) {
+				FT_Set_Pixel_Sizes(face, 0, request.pixelSize);
+			} else {
+				Log << Level::Error << "GlyphRasterizer: cannot load font " << request.fontPath << op::endl;
+				face = nullptr;
+			}
+			faces[key] = face;
+		}
+
+		if (!face) {
+			result->failed = true;
+		} else if (FT_Get_Char_Index(face, request.codepoint) == 0) {
+			result->missing = true;
+		} else if (FT_Load_Char(face, request.codepoint, request.distanceField ? FT_LOAD_DEFAULT : FT_LOAD_RENDER) ||
+			(request.distanceField && FT_Render_Glyph(face->glyph, FT_RENDER_MODE_SDF))) {
+			result->failed = true;
+		} else {
+			const FT_Bitmap& bitmap = face->glyph->bitmap;
+			result->metrics.width = static_cast<int>(bitmap.width);
+			result->metrics.height = static_cast<int>(bitmap.rows);
+			result->metrics.bearingX = face->glyph->bitmap_left;
+			result->metrics.bearingY = face->glyph->bitmap_top;
+			result->metrics.advance = static_cast<unsigned int>(face->glyph->advance.x);
+			// 按 pitch 逐行复制成紧密排列的位图
+			result->bitmap.resize(static_cast<size_t>(bitmap.width) * bitmap.rows);
+			for (unsigned int row = 0; row < bitmap.rows; ++row) {
+				const unsigned char* src = bitmap.pitch >= 0
+					? bitmap.buffer + static_cast<size_t>(row) * bitmap.pitch
+					: bitmap.buffer + static_cast<size_t>(bitmap.rows - 1 - row) * static_cast<size_t>(-bitmap.pitch);
+				std::memcpy(result->bitmap.data() + static_cast<size_t>(row) * bitmap.width, src, bitmap.width);
+			}
+		}
+		PushCompleted(result);
+	}
+
+	for (auto& pair : faces) {
+		if (pair.second) FT_Done_Face(pair.second);
+	}
+	if (library) FT_Done_FreeType(library);
+}
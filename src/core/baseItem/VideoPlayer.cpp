@@ -2,6 +2,12 @@
 
 #include "core/log.h"
 #include "core/baseItem/Bitmap.h"
+#include "core/baseItem/AudioGain.h"
+#include "core/render/Profiler.h"
+#include "core/render/DamageTracker.h"
+#include "core/render/StreamingTexture.h"
+#include "core/Config.h"
+#include "core/configItem.h"
 
 extern "C" {
 #include <libavformat/avformat.h>
@@ -10,12 +16,67 @@ extern "C" {
 #include <libavutil/imgutils.h>
 #include <libavutil/time.h>
 #include <libavutil/opt.h>
+#include <libavutil/hwcontext.h>
 #include <libswresample/swresample.h>
 }
 #include <SDL2/SDL.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+#include <vector>
+
 using namespace core;
 
+namespace {
+// 解码器协商输出格式：提供了硬件格式时选用，否则退回默认的软件格式
+AVPixelFormat SelectHwFormat(AVCodecContext* ctx, const AVPixelFormat* formats) {
+    const int wanted = *static_cast<const int*>(ctx->opaque);
+    for (const AVPixelFormat* p = formats; *p != AV_PIX_FMT_NONE; ++p) {
+        if (*p == wanted) return *p;
+    }
+    Log << Level::Warn << "硬件解码不支持此视频流，改用软件解码" << op::endl;
+    return avcodec_default_get_format(ctx, formats);
+}
+
+// 软件解码线程数：0 表示按CPU核心数
+int DecodeThreadCount(unsigned int configured) {
+    if (configured > 0) return static_cast<int>(configured);
+    const unsigned int cores = std::thread::hardware_concurrency();
+    // FFmpeg 建议帧线程不超过16个；核心数未知时交给 FFmpeg 自动决定
+    return cores == 0 ? 0 : static_cast<int>(std::min(cores, 16u));
+}
+
+// 帧环的缓冲区数：一帧正在显示，其余为解码线程提前解码的帧
+constexpr int kFrameRingSize = 5;
+// 没有音频时，下一帧与显示时钟相差超过此值（秒）视为时间轴跳变，重新对齐
+constexpr double kClockResync = 1.0;
+
+// 可以直接上传、由着色器转换颜色的解码格式
+bool DirectStreamFormat(AVPixelFormat format, StreamFormat& out) {
+    switch (format) {
+    case AV_PIX_FMT_YUV420P:
+    case AV_PIX_FMT_YUVJ420P:
+        out = StreamFormat::YUV420P;
+        return true;
+    case AV_PIX_FMT_NV12:
+        out = StreamFormat::NV12;
+        return true;
+    default:
+        return false;
+    }
+}
+
+AVPixelFormat StreamPixelFormat(StreamFormat format) {
+    switch (format) {
+    case StreamFormat::YUV420P: return AV_PIX_FMT_YUV420P;
+    case StreamFormat::NV12: return AV_PIX_FMT_NV12;
+    default: return AV_PIX_FMT_RGB24;
+    }
+}
+}
+
 std::atomic<float> VideoPlayer::volume{1.0f};
 
 VideoPlayer::VideoPlayer() : playing(false), loop(false), shouldExit(false) {
@@ -103,23 +164,8 @@ bool VideoPlayer::load(const std::string& path) {
             return false;
         }
         
-        // 获取视频流的解码器上下文
-        codecContext = avcodec_alloc_context3(nullptr);
-        if (!codecContext) {
-            Log << Level::Error << "无法分配解码器上下文" << op::endl;
-            cleanup();
-            return false;
-        }
-
-        if(avcodec_parameters_to_context(codecContext, formatContext->streams[videoStreamIndex]->codecpar)){
-            Log << Level::Error << "无法复制编解码器参数" << op::endl;
-            cleanup();
-            return false;
-        }
-
-        // 打开解码器
-        if (avcodec_open2(codecContext, codec, nullptr) < 0) {
-            Log << Level::Error << "无法打开解码器" << op::endl;
+        // 创建并打开解码器
+        if (!openVideoDecoder(codec)) {
             cleanup();
             return false;
         }
@@ -149,6 +195,30 @@ bool VideoPlayer::load(const std::string& path) {
         width = codecContext->width;
         height = codecContext->height;
 
+        // 常见的平面格式直接交给GPU转换，省去CPU上的颜色转换
+        // 硬件帧复制到内存后通常为 NV12（其他格式在写入时转换）
+        // 硬件解码可能退回软件格式，解码线程按第一帧的实际格式修正
+        const AVPixelFormat decodedFormat = hwPixelFormat >= 0 ? AV_PIX_FMT_NV12 : codecContext->pix_fmt;
+        if (!DirectStreamFormat(decodedFormat, streamFormat)) {
+            streamFormat = StreamFormat::RGB24;
+        }
+        // 未标注色彩空间时按分辨率猜测：高清视频通常为 BT.709
+        if (codecContext->colorspace == AVCOL_SPC_UNSPECIFIED) {
+            colorBt709 = height >= 720;
+        } else {
+            colorBt709 = codecContext->colorspace == AVCOL_SPC_BT709;
+        }
+        colorFullRange = codecContext->color_range == AVCOL_RANGE_JPEG
+            || codecContext->pix_fmt == AV_PIX_FMT_YUVJ420P;
+        if (hwPixelFormat >= 0) {
+            hwTransferFrame = av_frame_alloc();
+            if (!hwTransferFrame) {
+                Log << Level::Error << "无法分配硬件帧的传输帧" << op::endl;
+                cleanup();
+                return false;
+            }
+        }
+
         // 分配音频帧
         frame = av_frame_alloc();
         // 分配图像帧
@@ -159,25 +229,28 @@ bool VideoPlayer::load(const std::string& path) {
             return false;
         }
 
-        // 为RGB帧分配缓冲区
-        int numBytes = av_image_get_buffer_size(AV_PIX_FMT_RGB24, width, height, 1);
-        uint8_t* buffer = (uint8_t*)av_malloc(numBytes);
-        if (!buffer) {
-            Log << Level::Error << "无法分配RGB帧缓冲区" << op::endl;
-            cleanup();
-            return false;
-        }
-        av_image_fill_arrays(rgbFrame->data, rgbFrame->linesize, buffer, AV_PIX_FMT_RGB24, width, height, 1);
+        // 其他格式在CPU上转换为RGB
+        if (streamFormat == StreamFormat::RGB24) {
+            // 为RGB帧分配缓冲区
+            int numBytes = av_image_get_buffer_size(AV_PIX_FMT_RGB24, width, height, 1);
+            uint8_t* buffer = (uint8_t*)av_malloc(numBytes);
+            if (!buffer) {
+                Log << Level::Error << "无法分配RGB帧缓冲区" << op::endl;
+                cleanup();
+                return false;
+            }
+            av_image_fill_arrays(rgbFrame->data, rgbFrame->linesize, buffer, AV_PIX_FMT_RGB24, width, height, 1);
 
-        //初始化SWS上下文
-        swsContext = sws_getContext(width, height,
-            codecContext->pix_fmt, width, height, 
-            AV_PIX_FMT_RGB24, SWS_BILINEAR, nullptr, 
-            nullptr, nullptr);
-        if (!swsContext) {
-            Log << Level::Error << "无法初始化SWS上下文" << op::endl;
-            cleanup();
-            return false;
+            //初始化SWS上下文
+            swsContext = sws_getContext(width, height,
+                codecContext->pix_fmt, width, height, 
+                AV_PIX_FMT_RGB24, SWS_BILINEAR, nullptr, 
+                nullptr, nullptr);
+            if (!swsContext) {
+                Log << Level::Error << "无法初始化SWS上下文" << op::endl;
+                cleanup();
+                return false;
+            }
         }
         if (audioStreamIndex >= 0) {
             if(audioCodecContext!=nullptr){
@@ -240,6 +313,172 @@ bool VideoPlayer::load(const std::string& path) {
     }
 }
 
+bool VideoPlayer::openVideoDecoder(const AVCodec* codec) {
+    const AVCodecParameters* params = formatContext->streams[videoStreamIndex]->codecpar;
+    Config* config = Config::getInstance();
+    auto allocContext = [&]() {
+        codecContext = avcodec_alloc_context3(nullptr);
+        if (!codecContext) {
+            Log << Level::Error << "无法分配解码器上下文" << op::endl;
+            return false;
+        }
+        if (avcodec_parameters_to_context(codecContext, params) < 0) {
+            Log << Level::Error << "无法复制编解码器参数" << op::endl;
+            return false;
+        }
+        // 帧级与片级多线程；硬件解码在协商时可能退回软件解码，同样需要
+        codecContext->thread_count = DecodeThreadCount(config->getUInt(VIDEO_DECODE_THREADS, 0));
+        codecContext->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+        return true;
+    };
+
+    // video_hwaccel：auto 依次尝试本机支持的设备类型，none 只用软件解码，其他值为设备类型名（vaapi、d3d11va 等）
+    const std::string hwaccel = config->get(VIDEO_HWACCEL, "auto");
+    std::vector<AVHWDeviceType> candidates;
+    if (hwaccel == "auto") {
+        for (AVHWDeviceType type = av_hwdevice_iterate_types(AV_HWDEVICE_TYPE_NONE);
+             type != AV_HWDEVICE_TYPE_NONE; type = av_hwdevice_iterate_types(type)) {
+            candidates.push_back(type);
+        }
+    } else if (!hwaccel.empty() && hwaccel != "none") {
+        const AVHWDeviceType type = av_hwdevice_find_type_by_name(hwaccel.c_str());
+        if (type == AV_HWDEVICE_TYPE_NONE) {
+            Log << Level::Warn << "未知的硬件解码类型: " << hwaccel << op::endl;
+        } else {
+            candidates.push_back(type);
+        }
+    }
+
+    for (AVHWDeviceType type : candidates) {
+        // 解码器是否支持以此类设备解码
+        AVPixelFormat hwFormat = AV_PIX_FMT_NONE;
+        for (int i = 0;; ++i) {
+            const AVCodecHWConfig* hwConfig = avcodec_get_hw_config(codec, i);
+            if (!hwConfig) break;
+            if ((hwConfig->methods & AV_CODEC_HW_CONFIG_METHOD_HW_DEVICE_CTX) && hwConfig->device_type == type) {
+                hwFormat = hwConfig->pix_fmt;
+                break;
+            }
+        }
+        if (hwFormat == AV_PIX_FMT_NONE) continue;
+
+        AVBufferRef* device = nullptr;
+        if (av_hwdevice_ctx_create(&device, type, nullptr, nullptr, 0) < 0) {
+            Log << Level::Info << "无法创建硬件解码设备: " << av_hwdevice_get_type_name(type) << op::endl;
+            continue;
+        }
+        if (!allocContext()) {
+            av_buffer_unref(&device);
+            return false;
+        }
+        hwPixelFormat = hwFormat;
+        codecContext->opaque = &hwPixelFormat;
+        codecContext->get_format = SelectHwFormat;
+        codecContext->hw_device_ctx = av_buffer_ref(device);
+        if (codecContext->hw_device_ctx && avcodec_open2(codecContext, codec, nullptr) >= 0) {
+            hwDeviceContext = device;
+            Log << Level::Info << "视频使用硬件解码: " << av_hwdevice_get_type_name(type) << op::endl;
+            return true;
+        }
+        Log << Level::Warn << "硬件解码器打开失败: " << av_hwdevice_get_type_name(type) << op::endl;
+        avcodec_free_context(&codecContext);
+        av_buffer_unref(&device);
+        hwPixelFormat = -1;
+    }
+
+    // 软件解码
+    if (!allocContext()) {
+        return false;
+    }
+    if (avcodec_open2(codecContext, codec, nullptr) < 0) {
+        Log << Level::Error << "无法打开解码器" << op::endl;
+        return false;
+    }
+    Log << Level::Info << "视频使用软件解码，线程数: " << codecContext->thread_count << op::endl;
+    return true;
+}
+
+bool VideoPlayer::writeFrameToStream(AVFrame* src, StreamingTexture* stream, double pts) {
+    const AVPixelFormat target = StreamPixelFormat(stream->GetFormat());
+    const AVPixelFormat format = static_cast<AVPixelFormat>(src->format);
+    const bool sameFormat = format == target
+        || (target == AV_PIX_FMT_YUV420P && format == AV_PIX_FMT_YUVJ420P);
+    const bool sameSize = src->width == stream->GetWidth() && src->height == stream->GetHeight();
+
+    // 帧环满时等待；超时只是为了检查退出标志
+    unsigned char* dst = nullptr;
+    while (!dst) {
+        if (shouldExit) return false;
+        dst = stream->WaitWrite(std::chrono::milliseconds(20));
+    }
+    if (sameFormat && sameSize) {
+        // 各平面原样复制
+        for (int i = 0; i < stream->GetPlaneCount(); ++i) {
+            const StreamPlane& plane = stream->GetPlane(i);
+            const int rowBytes = plane.Stride();
+            const uint8_t* in = src->data[i];
+            unsigned char* out = dst + plane.offset;
+            if (src->linesize[i] == rowBytes) {
+                std::memcpy(out, in, static_cast<size_t>(rowBytes) * plane.height);
+            } else {
+                for (int y = 0; y < plane.height; ++y) {
+                    std::memcpy(out + static_cast<size_t>(y) * rowBytes,
+                                in + static_cast<ptrdiff_t>(y) * src->linesize[i], rowBytes);
+                }
+            }
+        }
+    } else {
+        // 硬件帧的内存格式（P010 等）或中途改变分辨率的帧
+        planeSwsContext = sws_getCachedContext(planeSwsContext, src->width, src->height, format,
+            stream->GetWidth(), stream->GetHeight(), target, SWS_BILINEAR, nullptr, nullptr, nullptr);
+        if (!planeSwsContext) {
+            stream->CancelWrite();
+            return false;
+        }
+        uint8_t* dstData[4] = { nullptr, nullptr, nullptr, nullptr };
+        int dstLinesize[4] = { 0, 0, 0, 0 };
+        for (int i = 0; i < stream->GetPlaneCount(); ++i) {
+            dstData[i] = dst + stream->GetPlane(i).offset;
+            dstLinesize[i] = stream->GetPlane(i).Stride();
+        }
+        sws_scale(planeSwsContext, src->data, src->linesize, 0, src->height, dstData, dstLinesize);
+    }
+    stream->EndWrite(pts);
+    return true;
+}
+
+AVPacket* VideoPlayer::acquirePacket() {
+    AVPacket* packet = nullptr;
+    if (freeVideoPackets.TryPop(packet) || freeAudioPackets.TryPop(packet)) {
+        return packet;
+    }
+    return av_packet_alloc();
+}
+
+void VideoPlayer::releasePacket(SpscQueue<AVPacket*>& pool, AVPacket* packet) {
+    if (!packet) return;
+    av_packet_unref(packet);
+    if (!pool.TryPush(packet)) {
+        av_packet_free(&packet);
+    }
+}
+
+void VideoPlayer::wakePacketQueues() {
+    packetVideoQueue.Wake();
+    packetAudioQueue.Wake();
+}
+
+void VideoPlayer::freeQueuedPackets() {
+    for (SpscQueue<AVPacket*>* queue : { &packetVideoQueue, &packetAudioQueue, &freeVideoPackets, &freeAudioPackets }) {
+        AVPacket* pkt = nullptr;
+        while (queue->TryPop(pkt)) {
+            if (pkt) {
+                av_packet_free(&pkt);
+            }
+        }
+    }
+}
+
 void VideoPlayer::play() {
     if (playing) return;
 
@@ -260,6 +499,10 @@ void VideoPlayer::play() {
     if (decoderThreadVideo.joinable()) {
         decoderThreadVideo.join();
     }
+    // 丢弃解码器中上一次播放残留的帧（包括排空后的结束状态）
+    avcodec_flush_buffers(codecContext);
+    presentClockValid = false;
+    audioGain = -1;
     // 重置同步时钟
     startTime = std::chrono::steady_clock::now();
     audioClock = 0.0;
@@ -286,23 +529,25 @@ void VideoPlayer::play() {
     decoderThread = std::thread(&VideoPlayer::decodeThread, this);
     decoderThreadVideo=std::thread(&VideoPlayer::decodeThreadVideo,this);
     if(audioStreamIndex>=0) decoderThreadAudio = std::thread(&VideoPlayer::decodeThreadAudio, this);
-    Log << Level::Info << "视频开始播放 (软件解码)" << op::endl;
+    Log << Level::Info << "视频开始播放 (" << (hwDeviceContext ? "硬件解码" : "软件解码") << ")" << op::endl;
 }
 
 void VideoPlayer::stop() {
-    if (!playing && !decoderThread.joinable()) return;
+    if (!playing && !decoderThread.joinable() && !decoderThreadVideo.joinable() && !decoderThreadAudio.joinable()) return;
 
     // 设置退出标志
     shouldExit = true;
     playing = false;
+    // 阻塞在包队列上的线程需要唤醒才能看到退出标志
+    wakePacketQueues();
 
-    // 使用超时等待线程结束，避免无限等待
+    // 必须等线程结束：之后的 cleanup() 会释放它们正在使用的解码器、帧和流纹理。
+    // 各等待点（包队列、帧环、流纹理创建）都会检查退出标志，线程很快就会返回
     auto waitForThread = [](std::thread& t, const std::string& name) {
         if (t.joinable()) {
             Log << Level::Info << "等待" << name << "线程结束..." << op::endl;
-            // 使用detach而不是join，让线程在后台自然结束
-            t.detach();
-            Log << Level::Info << name << "线程已分离" << op::endl;
+            t.join();
+            Log << Level::Info << name << "线程已结束" << op::endl;
         }
     };
 
@@ -321,6 +566,7 @@ void VideoPlayer::setLoop(bool enable) {
 }
 
 std::shared_ptr<Bitmap> VideoPlayer::getCurrentFrame() {
+    PROFILE_SCOPE("video upload");
     // 添加额外的检查以防止在视频已停止时访问互斥锁
     if (!playing && shouldExit) {
         return nullptr;
@@ -329,32 +575,70 @@ std::shared_ptr<Bitmap> VideoPlayer::getCurrentFrame() {
     if (!frameReady) {
         return nullptr;
     }
-    
-    std::shared_ptr<FrameData> frameData;
+
+    // 流纹理在主线程（GL线程）按视频尺寸创建一次，之后每帧只更新内容
+    if (!frameStream) {
+        if (width <= 0 || height <= 0) {
+            return nullptr;
+        }
+        frameStream = std::make_unique<StreamingTexture>(width, height, streamFormat, kFrameRingSize);
+        if (!frameStream->GetTexture()) {
+            frameStream.reset();
+            return nullptr;
+        }
+        frameStream->SetColorSpace(colorBt709, colorFullRange);
+        frameBitmap = std::make_shared<Bitmap>(frameStream->GetTexture());
+        frameStreamPtr.store(frameStream.get(), std::memory_order_release);
+    }
+
+    // 流纹理创建之前解码的帧仍在 currentFrameData 中
+    std::shared_ptr<FrameData> pending;
     {
         std::lock_guard<std::mutex> lock(frameMutex);
-        if (!currentFrameData) {
-            return nullptr;
+        pending = std::move(currentFrameData);
+        currentFrameData = nullptr;
+    }
+    if (pending && pending->data && pending->width == width && pending->height == height) {
+        frameStream->Upload(pending->data);
+    }
+    // 按时钟显示已到期的帧；暂停时保持当前帧
+    if (playing) {
+        const double clock = getPresentationClock();
+        frameStream->Update(clock);
+        // 还有未到期的帧：到期时再重绘（按需渲染时没有别的事件唤醒主循环），期间主循环可以休眠
+        double next = 0.0;
+        if (frameStream->PeekNext(next)) {
+            DamageTracker::Get().InvalidateAfter(next - clock);
         }
-        
-        // 创建一个新的FrameData对象并复制数据
-        frameData = std::make_shared<FrameData>(currentFrameData->width, currentFrameData->height);
-        memcpy(frameData->data, currentFrameData->data, currentFrameData->width * currentFrameData->height * 3);
     }
-    
-    // 在主线程中创建Bitmap对象，不会有跨线程问题
-    if (!frameData || !frameData->data) {
-        return nullptr;
-    }    
-    
-    // 创建位图（此时在主线程中，可以安全创建纹理），使用RGB格式避免数据转换
-    std::shared_ptr<Bitmap> bitmap = std::make_shared<Bitmap>(frameData->width, frameData->height, true, true);
-    
-    // 直接从原始数据创建纹理，使用RGB格式避免RGB到RGBA的转换，大幅减少内存使用
-    bitmap->CreateFromRGBData(frameData->data, frameData->width, frameData->height, true, true);
-    
-    // frameData 会在函数结束时自动释放
-    return bitmap;
+
+    // 返回的位图共享同一个纹理，下一次调用后内容会变为新的一帧
+    return frameStream->HasFrame() ? frameBitmap : nullptr;
+}
+
+double VideoPlayer::getPresentationClock() {
+    // 有音频时以声卡实际播放到的位置为准：音频时钟是已送入设备的数据末尾，减去设备中尚未播放的部分
+    if (audioStreamIndex >= 0 && audioDeviceID > 0 && audioCodecContext && !audioDecodeFinished) {
+        presentClockValid = false;
+        const double bytesPerSecond = static_cast<double>(audioCodecContext->sample_rate)
+            * audioCodecContext->ch_layout.nb_channels * av_get_bytes_per_sample(AV_SAMPLE_FMT_S16);
+        if (bytesPerSecond > 0) {
+            return getAudioClock() - SDL_GetQueuedAudioSize(audioDeviceID) / bytesPerSecond;
+        }
+    }
+
+    // 没有音频：按墙钟推进
+    const auto now = std::chrono::steady_clock::now();
+    double clock = std::chrono::duration<double>(now - presentClockBase).count();
+    double next = 0.0;
+    // 第一帧、恢复播放或循环回到开头时按下一帧重新对齐
+    if (frameStream && frameStream->PeekNext(next) && (!presentClockValid || std::abs(next - clock) > kClockResync)) {
+        presentClockBase = now - std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(next));
+        presentClockValid = true;
+        clock = next;
+    }
+    return clock;
 }
 
 void VideoPlayer::pause() {
@@ -377,6 +661,8 @@ void VideoPlayer::resume() {
     reachedEOF = false;
     videoDecodeFinished = false;
     audioDecodeFinished = false;
+    // 暂停期间墙钟仍在走，显示时钟需要重新对齐
+    presentClockValid = false;
     // 恢复音频播放
     if (audioStreamIndex >= 0 && audioDeviceID > 0) {
         SDL_PauseAudioDevice(audioDeviceID, 0); // 恢复音频设备
@@ -401,29 +687,19 @@ void VideoPlayer::applyVolume(uint8_t* audioBuffer, int bufferSize, int channels
         return;
     }
 
-    float currentVolume = VideoPlayer::volume.load();
-    if (currentVolume >= 1.0f) {
+    const int targetGain = GainToQ15(VideoPlayer::volume.load());
+    // 音量改变时从上一块的音量过渡到新音量，避免爆音；第一块直接使用目标音量
+    const int startGain = audioGain < 0 ? targetGain : audioGain;
+    audioGain = targetGain;
+    if (startGain == kUnityGain && targetGain == kUnityGain) {
         // 音量为最大时，无需处理
         return;
     }
-    
-    // 音频数据格式为 AUDIO_S16SYS (16位有符号整数)
+
+    // 音频数据格式为 AUDIO_S16SYS (16位有符号整数)，各声道交错排列，逐样本处理即可
+    (void)channels;
     int16_t* samples = reinterpret_cast<int16_t*>(audioBuffer);
-    int sampleCount = bufferSize / sizeof(int16_t);
-    
-    for (int i = 0; i < sampleCount; i++) {
-        // 应用音量并防止溢出
-        float sample = static_cast<float>(samples[i]) * currentVolume;
-        
-        // 限制在16位有符号整数范围内
-        if (sample > 32767.0f) {
-            samples[i] = 32767;
-        } else if (sample < -32768.0f) {
-            samples[i] = -32768;
-        } else {
-            samples[i] = static_cast<int16_t>(sample);
-        }
-    }
+    ApplyGainS16(samples, static_cast<size_t>(bufferSize) / sizeof(int16_t), startGain, targetGain);
 }
 
 void VideoPlayer::decodeThread(){
@@ -432,16 +708,15 @@ void VideoPlayer::decodeThread(){
 
     av_seek_frame(formatContext, videoStreamIndex, 0, AVSEEK_FLAG_BACKWARD);
 
+    // 读取失败或不需要的包留到下一次读取
+    AVPacket* spare = nullptr;
+    auto stopWaiting = [this] { return shouldExit.load(); };
     while(!shouldExit){
         if(!playing){
             std::this_thread::sleep_for(std::chrono::milliseconds(10)); // 减少睡眠时间
             continue;
         }
-        if(packetVideoQueue.size()>20||packetAudioQueue.size()>200){
-            std::this_thread::sleep_for(std::chrono::milliseconds(50)); // 避免过多包积压
-            continue;
-        }
-        AVPacket* packet = av_packet_alloc();
+        AVPacket* packet = spare ? std::exchange(spare, nullptr) : acquirePacket();
         if (!packet) {
             Log << Level::Error << "无法分配AVPacket" << op::endl;
             std::this_thread::sleep_for(std::chrono::milliseconds(100)); // 添加延迟，避免无限循环消耗CPU
@@ -450,6 +725,7 @@ void VideoPlayer::decodeThread(){
         // 读取视频帧
         ret = av_read_frame(formatContext, packet);
         if (ret < 0) {
+            spare = packet;
             if (ret == AVERROR_EOF) {
                 Log << Level::Info << "已读取完所有数据包" << op::endl;
                 if (loop) {
@@ -458,6 +734,7 @@ void VideoPlayer::decodeThread(){
                 }
                 else{
                     reachedEOF = true; // 标记已读取完所有数据包，但不立即设置播放完成
+                    wakePacketQueues();
                     break; // 直接退出，不需要等待
                 }
             }
@@ -466,120 +743,140 @@ void VideoPlayer::decodeThread(){
             continue;
         }
 
+        // 队列满时阻塞，直到解码线程取走包或播放停止
+        bool queued = false;
         if (packet->stream_index == videoStreamIndex) {
-            packetVideoQueue.push(packet);
+            queued = packetVideoQueue.WaitPush(packet, stopWaiting);
         }
         else if (packet->stream_index == audioStreamIndex) {
-            packetAudioQueue.push(packet);
+            queued = packetAudioQueue.WaitPush(packet, stopWaiting);
         }
-        else {
+        if (!queued) {
             av_packet_unref(packet); // 释放不需要的包
-            continue;
+            spare = packet;
         }
-        
     }
-    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    if (spare) {
+        av_packet_free(&spare);
+    }
+    // 正常播放结束时留时间给解码线程处理剩余的包；stop() 请求退出时不必等待
+    if (!shouldExit) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    }
     playing=false;
     isFinished=true;
 }
 
 void VideoPlayer::decodeThreadVideo() {
     char buf[AV_ERROR_MAX_STRING_SIZE]{0};
+    bool draining = false;
+    auto stopWaiting = [this] { return shouldExit.load() || reachedEOF.load(); };
     while (!shouldExit) {
-        auto now = std::chrono::steady_clock::now();
         if (!playing) {
             std::this_thread::sleep_for(std::chrono::milliseconds(10)); // 减少睡眠时间
             isFinished=true; // 如果暂停或停止，直接设置为完成状态
             continue;
         }
         
-        // 检查是否没有更多视频包并且已到达EOF
-        if (packetVideoQueue.empty()) {
-            if (reachedEOF.load()) {
-                Log << Level::Info << "视频队列为空且已到达EOF，视频解码完成" << op::endl;
-                videoDecodeFinished = true;
-                // 检查是否可以设置播放完成
-                if (audioStreamIndex < 0 || audioDecodeFinished.load()) {
-                    Log << Level::Info << "所有解码完成，设置播放完成" << op::endl;
-                    isFinished = true;
-                }
-                break;
+        // 等待视频包；没有更多视频包并且已到达EOF时排空解码器
+        AVPacket* packet = nullptr;
+        if (!draining && !packetVideoQueue.WaitPop(packet, stopWaiting)) {
+            if (shouldExit || !reachedEOF.load()) continue;
+            // 多线程解码器内还缓存着最后几帧：发送空包排空
+            avcodec_send_packet(codecContext, nullptr);
+            draining = true;
+        }
+
+        if (packet) {
+            int ret = avcodec_send_packet(codecContext, packet);
+            if (ret < 0) {
+                Log << Level::Error << "发送视频包失败: " << av_make_error_string(buf, sizeof(buf), ret) << op::endl;
+                releasePacket(freeVideoPackets, packet);
+                continue;
             }
-            std::this_thread::sleep_for(std::chrono::milliseconds(5)); // 减少睡眠时间
-            continue;
         }
 
-        AVPacket* packet = packetVideoQueue.front();
-        packetVideoQueue.pop();
-        if(!packet) continue;
-        int ret = avcodec_send_packet(codecContext, packet);
+        int ret = avcodec_receive_frame(codecContext, frame);
+        if (ret == AVERROR_EOF || (draining && ret < 0)) {
+            Log << Level::Info << "视频队列为空且已到达EOF，视频解码完成" << op::endl;
+            videoDecodeFinished = true;
+            // 检查是否可以设置播放完成
+            if (audioStreamIndex < 0 || audioDecodeFinished.load()) {
+                Log << Level::Info << "所有解码完成，设置播放完成" << op::endl;
+                isFinished = true;
+            }
+            break;
+        }
         if (ret < 0) {
-            Log << Level::Error << "发送视频包失败: " << av_make_error_string(buf, sizeof(buf), ret) << op::endl;
-            av_packet_unref(packet);
+            // 帧线程解码时前几个包不会立即输出帧
+            if (ret != AVERROR(EAGAIN)) {
+                Log << Level::Error << "接收视频帧失败: " << av_make_error_string(buf, sizeof(buf), ret) << op::endl;
+            }
+            releasePacket(freeVideoPackets, packet);
             continue;
         }
 
-        ret = avcodec_receive_frame(codecContext, frame);
-        if (ret < 0) {
-            Log << Level::Error << "接收视频帧失败: " << av_make_error_string(buf, sizeof(buf), ret) << op::endl;
-            av_packet_unref(packet);
-            continue;
+        // 硬件帧先复制到内存
+        AVFrame* image = frame;
+        if (hwPixelFormat >= 0 && frame->format == hwPixelFormat) {
+            av_frame_unref(hwTransferFrame);
+            ret = av_hwframe_transfer_data(hwTransferFrame, frame, 0);
+            if (ret < 0) {
+                Log << Level::Error << "硬件帧传输失败: " << av_make_error_string(buf, sizeof(buf), ret) << op::endl;
+                releasePacket(freeVideoPackets, packet);
+                continue;
+            }
+            image = hwTransferFrame;
         }
 
-        // 获取视频帧的PTS并进行同步
-        double videoPts = convertPtsToSeconds(frame->pts, formatContext->streams[videoStreamIndex]->time_base);
+        // 获取视频帧的PTS（帧线程解码时 pts 可能缺失，用推算的时间戳）
+        double videoPts = convertPtsToSeconds(frame->best_effort_timestamp, formatContext->streams[videoStreamIndex]->time_base);
         videoPts = synchronizeVideo(frame, videoPts);
-        
-        // 转换为RGB格式
-        sws_scale(swsContext, frame->data, frame->linesize, 0, height, rgbFrame->data, rgbFrame->linesize);
 
-        // 将RGB帧转换为FrameData
-        std::shared_ptr<FrameData> frameData = convertFrameToFrameData(rgbFrame);
-        
-        if (frameData) {
-            std::lock_guard<std::mutex> lock(frameMutex);
-            currentFrameData = frameData;
-            frameReady = true;
-        }
-        
-        av_packet_unref(packet); // 释放包
-        
-        // 计算同步延迟
-        auto now_ = std::chrono::steady_clock::now();
-        std::chrono::duration<float> elapsed = now_ - now;
-        if(audioStreamIndex>=0){
-            // 基于音视频同步的帧延迟计算
-            double audioTime = getAudioClock();
-            double diff = videoPts - audioTime;
-            
-            // 同步阈值检查
-            double delay = frameLastDelay.load();
-            if (delay <= 0 || delay >= 1.0) {
-                delay = 1.0 / fps; // 默认帧间隔
+        StreamingTexture* stream = frameStreamPtr.load(std::memory_order_acquire);
+        if (!stream) {
+            // 流纹理还没有创建（主线程第一次取帧之前）
+            // 按第一帧的实际格式选择流纹理格式：硬件解码退回软件解码时帧为 YUV420P 等，
+            // 仍按 NV12 创建会使每帧都经过 sws_scale。RGB 路径的转换上下文已按解码器格式建立，保持不变
+            StreamFormat actual;
+            if (streamFormat != StreamFormat::RGB24
+                && DirectStreamFormat(static_cast<AVPixelFormat>(image->format), actual)) {
+                streamFormat = actual;
+                colorFullRange = colorFullRange || image->color_range == AVCOL_RANGE_JPEG
+                    || image->format == AV_PIX_FMT_YUVJ420P;
             }
-            
-            if (std::abs(diff) < syncThreshold) {
-                // 在同步范围内，正常播放
-            } else if (diff < -syncThreshold) {
-                // 视频滞后，减少延迟
-                delay = delay * 0.8;
-            } else if (diff > syncThreshold) {
-                // 视频超前，增加延迟
-                delay = delay + diff;
+            if (streamFormat == StreamFormat::RGB24) {
+                // 转换为RGB格式
+                sws_scale(swsContext, frame->data, frame->linesize, 0, height, rgbFrame->data, rgbFrame->linesize);
+
+                // 将RGB帧转换为FrameData
+                std::shared_ptr<FrameData> frameData = convertFrameToFrameData(rgbFrame);
+
+                if (frameData) {
+                    std::lock_guard<std::mutex> lock(frameMutex);
+                    currentFrameData = frameData;
+                }
             }
-            
-            frameLastDelay = delay;
-            
-            // 计算实际需要等待的时间
-            int sleepTime = static_cast<int>((delay - elapsed.count()) * 1000);
-            if (sleepTime > 0 && sleepTime < 100) { // 限制在合理范围内
-                std::this_thread::sleep_for(std::chrono::milliseconds(sleepTime));
+            frameReady = true;
+            DamageTracker::Get().Invalidate();
+            // 等主线程创建流纹理，不越过开头的帧继续解码
+            while (!shouldExit && !(stream = frameStreamPtr.load(std::memory_order_acquire))) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+            // RGB 帧已经交给主线程
+            if (!stream || streamFormat == StreamFormat::RGB24) {
+                releasePacket(freeVideoPackets, packet);
+                continue;
             }
         }
-        else{
-            // 音频不存在
-            std::this_thread::sleep_for(std::chrono::milliseconds(int(1000/fps-elapsed.count()*1000)));
+
+        // 排入帧环，由渲染线程按时钟显示。环满时在这里等待，解码的节奏由显示决定，不再睡眠估算
+        if (writeFrameToStream(image, stream, videoPts)) {
+            // 新帧需要显示；播放器不知道画在哪里，整窗重绘
+            DamageTracker::Get().Invalidate();
         }
+
+        releasePacket(freeVideoPackets, packet); // 归还包
     }
 }
 
@@ -590,32 +887,25 @@ void VideoPlayer::decodeThreadAudio() {
         Log << Level::Error << "无法分配音频帧" << op::endl;
         return;
     }
+    auto stopWaiting = [this] { return shouldExit.load() || reachedEOF.load(); };
     while (!shouldExit) {
         if (!playing) {
             std::this_thread::sleep_for(std::chrono::milliseconds(10)); // 减少睡眠时间
             continue;
         }
 
-        // 检查是否没有更多音频包并且已到达EOF
-        if (packetAudioQueue.empty()) {
-            if (reachedEOF.load()) {
-                Log << Level::Info << "音频队列为空且已到达EOF，音频解码完成" << op::endl;
-                audioDecodeFinished = true;
-                // 检查是否可以设置播放完成
-                if (videoDecodeFinished.load()) {
-                    Log << Level::Info << "所有解码完成，设置播放完成" << op::endl;
-                    isFinished = true;
-                }
-                break;
-            }
-            std::this_thread::sleep_for(std::chrono::milliseconds(5)); // 减少睡眠时间
-            continue;
-        }
-
+        // 等待音频包；没有更多音频包并且已到达EOF时结束
         AVPacket* packet = nullptr;
-        if (!packetAudioQueue.empty()) {
-            packet = packetAudioQueue.front();
-            packetAudioQueue.pop();
+        if (!packetAudioQueue.WaitPop(packet, stopWaiting)) {
+            if (shouldExit || !reachedEOF.load()) continue;
+            Log << Level::Info << "音频队列为空且已到达EOF，音频解码完成" << op::endl;
+            audioDecodeFinished = true;
+            // 检查是否可以设置播放完成
+            if (videoDecodeFinished.load()) {
+                Log << Level::Info << "所有解码完成，设置播放完成" << op::endl;
+                isFinished = true;
+            }
+            break;
         }
         
         char buf[AV_ERROR_MAX_STRING_SIZE]{0};
@@ -637,9 +927,9 @@ void VideoPlayer::decodeThreadAudio() {
             } else {
                 Log << Level::Warn << "发送音频包失败: " << av_make_error_string(buf, sizeof(buf), ret) << op::endl;
             }
-            if (packet) av_packet_unref(packet);
+            releasePacket(freeAudioPackets, packet);
         } else {
-            if (packet) av_packet_unref(packet);
+            releasePacket(freeAudioPackets, packet);
         }
         
         // 尝试接收解码后的帧
@@ -809,20 +1099,8 @@ void VideoPlayer::cleanup() {
     
     try {
         // 清理队列（先清理队列，避免后续访问已释放的上下文）
-        while (!packetVideoQueue.empty()) {
-            AVPacket* pkt = packetVideoQueue.front();
-            packetVideoQueue.pop();
-            if (pkt) {
-                av_packet_free(&pkt);
-            }
-        }
-        while (!packetAudioQueue.empty()) {
-            AVPacket* pkt = packetAudioQueue.front();
-            packetAudioQueue.pop();
-            if (pkt) {
-                av_packet_free(&pkt);
-            }
-        }
+        // 调用方已通过 stop() 等待解码线程结束，此时没有线程再读写包队列
+        freeQueuedPackets();
         
         // 清理音频设备（在清理音频上下文之前）
         if (audioDeviceID > 0) {
@@ -864,12 +1142,24 @@ void VideoPlayer::cleanup() {
             sws_freeContext(swsContext);
             swsContext = nullptr;
         }
+        if (planeSwsContext) {
+            sws_freeContext(planeSwsContext);
+            planeSwsContext = nullptr;
+        }
+        if (hwTransferFrame) {
+            av_frame_free(&hwTransferFrame);
+        }
         
         // 清理视频解码器上下文
         if (codecContext) {
             avcodec_free_context(&codecContext);
             codecContext = nullptr;
         }
+        // 解码器上下文持有自己的引用，最后释放设备
+        if (hwDeviceContext) {
+            av_buffer_unref(&hwDeviceContext);
+        }
+        hwPixelFormat = -1;
         
         // 最后清理格式上下文（这是最容易出错的地方）
         if (formatContext) {
@@ -921,6 +1211,10 @@ void VideoPlayer::cleanup() {
             currentFrameData = nullptr;
             frameReady = false;
         }
+        // stop() 已请求解码线程退出；先撤下指针，之后的帧不再写入流纹理
+        frameStreamPtr.store(nullptr, std::memory_order_release);
+        frameBitmap.reset();
+        frameStream.reset();
         
     } catch (const std::exception& e) {
         Log << Level::Error << "清理过程中发生异常: " << e.what() << op::endl;
@@ -987,22 +1281,15 @@ void VideoPlayer::updateAudioClock(double audioTimestamp, int audioDataSize) {
 }
 
 void VideoPlayer::cleanBuffer(){
-    while(!packetVideoQueue.empty()) {
-        AVPacket* pkt = packetVideoQueue.front();
-        packetVideoQueue.pop();
-        if (pkt) {
-            av_packet_free(&pkt);
-        }
-    }
-    while(!packetAudioQueue.empty()) {
-        AVPacket* pkt = packetAudioQueue.front();
-        packetAudioQueue.pop();
-        if (pkt) {
-            av_packet_free(&pkt);
-        }
-    }
+    // 包队列是单生产者单消费者的，解码线程仍在读写时不能从这里取出；先停止并等待线程结束
+    stop();
+    freeQueuedPackets();
     // 清空SDL音频队列
     if (audioDeviceID) {
         SDL_ClearQueuedAudio(audioDeviceID);
     }
+}
+
+StreamingTextureStats VideoPlayer::getFrameStreamStats() const {
+    return frameStream ? frameStream->GetStats() : StreamingTextureStats{};
 }
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include <GLFW/glfw3.h>
+#include "core/render/DamageTracker.h"
+#include "core/baseItem/Base.h"
+#include "core/Config.h"
+#include "core/configItem.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace core;
+
+DamageTracker& DamageTracker::Get() {
+    static DamageTracker instance;
+    return instance;
+}
+
+DamageTracker::DamageTracker() {
+    m_onDemand = Config::getInstance()->getBool(ON_DEMAND_RENDER, false);
+    m_partial = Config::getInstance()->getBool(PARTIAL_REDRAW, false);
+}
+
+void DamageTracker::Rect::Merge(const Rect& other) {
+    if (other.Empty()) return;
+    if (Empty()) {
+        *this = other;
+        return;
+    }
+    x0 = std::min(x0, other.x0);
+    y0 = std::min(y0, other.y0);
+    x1 = std::max(x1, other.x1);
+    y1 = std::max(y1, other.y1);
+}
+
+void DamageTracker::Wake() {
+    if (!m_dirty.exchange(true) && m_onDemand) {
+        glfwPostEmptyEvent();
+    }
+}
+
+void DamageTracker::Invalidate() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_full = true;
+    }
+    Wake();
+}
+
+void DamageTracker::Invalidate(const Region& region) {
+    Invalidate(region.getx(), region.gety(), region.getxend(), region.getyend());
+}
+
+void DamageTracker::Invalidate(float x0, float y0, float x1, float y1) {
+    const Rect rect = { std::min(x0, x1), std::min(y0, y1), std::max(x0, x1), std::max(y0, y1) };
+    if (rect.Empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_damage.Merge(rect);
+    }
+    Wake();
+}
+
+void DamageTracker::InvalidateAfter(double seconds) {
+    const auto deadline = std::chrono::steady_clock::now()
+        + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(std::max(seconds, 0.0)));
+    bool earlier;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        earlier = !m_hasDeadline || deadline < m_deadline;
+        if (earlier) {
+            m_deadline = deadline;
+            m_hasDeadline = true;
+        }
+    }
+    // 主循环正按更晚的时间等待：唤醒它重新计算超时
+    if (earlier && m_onDemand && m_waiting) {
+        glfwPostEmptyEvent();
+    }
+}
+
+void DamageTracker::CheckDeadline() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_hasDeadline || std::chrono::steady_clock::now() < m_deadline) return;
+        m_hasDeadline = false;
+        m_full = true;
+    }
+    m_dirty = true;
+}
+
+void DamageTracker::SetOnDemand(bool enable) {
+    m_onDemand = enable;
+    // 切换后先完整绘制一帧
+    Invalidate();
+}
+
+void DamageTracker::SetPartialRedraw(bool enable) {
+    m_partial = enable;
+    Invalidate();
+}
+
+RedrawPlan DamageTracker::BeginFrame(int framebufferWidth, int framebufferHeight) {
+    RedrawPlan plan;
+    CheckDeadline();
+    if (!m_onDemand) {
+        m_dirty = false;
+        m_stats.framesRendered++;
+        return plan;
+    }
+    if (!m_dirty.exchange(false)) {
+        plan.redraw = false;
+        return plan;
+    }
+
+    bool full;
+    Rect damage;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        full = m_full;
+        damage = m_damage;
+        m_full = false;
+        m_damage = { 0, 0, 0, 0 };
+    }
+
+    // 后缓冲区里是上上帧的内容，需要把上一帧的损坏区域一起补上
+    const bool prevFull = m_prevFull;
+    const Rect prevDamage = m_prevDamage;
+    m_prevFull = full || !m_partial;
+    m_prevDamage = damage;
+    if (!m_partial || full || prevFull) {
+        m_stats.framesRendered++;
+        return plan;
+    }
+
+    damage.Merge(prevDamage);
+    // 扩展到整数像素并裁剪到帧缓冲区
+    const int x0 = std::clamp(static_cast<int>(std::floor(damage.x0)), 0, framebufferWidth);
+    const int y0 = std::clamp(static_cast<int>(std::floor(damage.y0)), 0, framebufferHeight);
+    const int x1 = std::clamp(static_cast<int>(std::ceil(damage.x1)), 0, framebufferWidth);
+    const int y1 = std::clamp(static_cast<int>(std::ceil(damage.y1)), 0, framebufferHeight);
+    if (x1 <= x0 || y1 <= y0) {
+        // 损坏区域都在窗口外，本帧没有需要重绘的内容
+        plan.redraw = false;
+        return plan;
+    }
+    plan.scissor = true;
+    plan.x = x0;
+    plan.y = framebufferHeight - y1;
+    plan.width = x1 - x0;
+    plan.height = y1 - y0;
+    m_stats.framesRendered++;
+    m_stats.framesPartial++;
+    return plan;
+}
+
+void DamageTracker::WaitEvents() {
+    m_stats.idleWaits++;
+    double timeout = m_idleTimeout;
+    m_waiting = true;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_hasDeadline) {
+            const double remaining = std::chrono::duration<double>(m_deadline - std::chrono::steady_clock::now()).count();
+            timeout = std::clamp(remaining, 0.0, m_idleTimeout);
+        }
+    }
+    if (timeout > 0.0) {
+        glfwWaitEventsTimeout(timeout);
+    } else {
+        glfwPollEvents();
+    }
+    m_waiting = false;
+}
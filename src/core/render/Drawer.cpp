@@ -1,23 +1,36 @@
 #include "core/render/Drawer.h"
 #include "core/render/GLBase.h"
+#include "core/render/GLStateCache.h"
+#include "core/render/Renderer.h"
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <vector>
 
 using namespace core;
 
+namespace {
+// 圆形分段数
+constexpr int kCircleSegments = 36;
+// 与 glLineStipple(1, 0x00FF) 一致：8像素实线、8像素空白
+constexpr float kDashLength = 8.0f;
+}
+
 Drawer::Drawer(GLFWwindow* window) : m_window(window) {
     
     // 启用Alpha混合（正确设置处理半透明）
-    GLCall(glEnable(GL_BLEND));
-    GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+    GLStateCache::Get().SetBlend(true);
+    GLStateCache::Get().BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     GLCall(glBlendEquation(GL_FUNC_ADD));
     
     // 初始化默认着色器
     InitDefaultShader();
+    InitBatchResources();
 }
 
 Drawer::~Drawer() {
     // 清理资源
+    Renderer::Get().ReleaseBatcher(this);
 }
 
 void Drawer::InitDefaultShader() {
@@ -44,6 +57,117 @@ void Drawer::InitDefaultShader() {
     )";
 
     defaultShader.init(vertexShaderSource, fragmentShaderSource);
+    m_colorUniform = defaultShader.GetUniform("u_Color");
+}
+
+void Drawer::InitBatchResources() {
+    // 批处理着色器：颜色作为顶点属性传入，整批只需一次绘制
+    static const char* vertexShaderSource = R"(
+    #version 330 core
+    layout(location = 0) in vec2 aPos;
+    layout(location = 1) in vec4 aColor;
+    out vec4 vColor;
+
+    void main()
+    {
+        gl_Position = vec4(aPos, 0.0, 1.0);
+        vColor = aColor;
+    }
+    )";
+
+    static const char* fragmentShaderSource = R"(
+    #version 330 core
+    in vec4 vColor;
+    out vec4 FragColor;
+
+    void main()
+    {
+        FragColor = vColor;
+    }
+    )";
+
+    m_batchShader.init(vertexShaderSource, fragmentShaderSource);
+
+    m_batchVa.AddBuffer(m_batchVb, 0, 2, GL_FLOAT, false, sizeof(BatchVertex), (const void*)offsetof(BatchVertex, x));
+    m_batchVa.AddBuffer(m_batchVb, 1, 4, GL_UNSIGNED_BYTE, true, sizeof(BatchVertex), (const void*)offsetof(BatchVertex, r));
+    m_vertices.reserve(4096);
+}
+
+void Drawer::SetBatchMode(bool enable) {
+    if (m_batchMode == enable) return;
+    Flush();
+    m_batchMode = enable;
+}
+
+void Drawer::BeginAppend() {
+    // 其他批处理器（文字等）的数据先提交，保证绘制顺序
+    Renderer::Get().SetActiveBatcher(this, &Drawer::FlushThunk);
+}
+
+void Drawer::PushVertex(glm::vec2 screen, const Color& color) {
+    glm::vec2 ndc = ScreenToNDC(screen.x, screen.y);
+    m_vertices.push_back({ndc.x, ndc.y, color.r, color.g, color.b, color.a});
+}
+
+void Drawer::PushTriangle(glm::vec2 a, glm::vec2 b, glm::vec2 c, const Color& color) {
+    PushVertex(a, color);
+    PushVertex(b, color);
+    PushVertex(c, color);
+}
+
+void Drawer::PushQuad(glm::vec2 a, glm::vec2 b, glm::vec2 c, glm::vec2 d, const Color& color) {
+    PushTriangle(a, b, c, color);
+    PushTriangle(a, c, d, color);
+}
+
+void Drawer::PushLine(glm::vec2 start, glm::vec2 end, const Color& color, bool dashed) {
+    glm::vec2 dir = end - start;
+    float length = std::sqrt(dir.x * dir.x + dir.y * dir.y);
+    if (length < 1e-4f) return;
+    dir /= length;
+    // 线宽1像素：沿法线方向各扩展半个像素
+    glm::vec2 n(-dir.y * 0.5f, dir.x * 0.5f);
+
+    if (!dashed) {
+        PushQuad(start + n, end + n, end - n, start - n, color);
+        return;
+    }
+    for (float t = 0.0f; t < length; t += kDashLength * 2.0f) {
+        glm::vec2 a = start + dir * t;
+        glm::vec2 b = start + dir * std::min(t + kDashLength, length);
+        PushQuad(a + n, b + n, b - n, a - n, color);
+    }
+}
+
+void Drawer::Flush() {
+    Renderer::Get().ReleaseBatcher(this);
+    if (m_vertices.empty()) return;
+
+    unsigned int bytes = static_cast<unsigned int>(m_vertices.size() * sizeof(BatchVertex));
+    if (bytes > m_batchCapacity) {
+        // 按倍数扩容，避免每帧重新分配
+        m_batchCapacity = std::max(bytes, m_batchCapacity * 2);
+    }
+    // 孤立旧存储后再写入，避免等待GPU读完上一批数据
+    m_batchVb.BufferData(nullptr, m_batchCapacity, GL_STREAM_DRAW);
+    m_batchVb.BufferSubData(0, bytes, m_vertices.data());
+    m_stats.bufferUploads++;
+
+    GLStateCache::Get().SetBlend(true);
+    GLStateCache::Get().BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    m_batchShader.use();
+    m_batchVa.Bind();
+    GLCall(glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(m_vertices.size())));
+
+    m_stats.drawCalls++;
+    m_stats.vertices += static_cast<unsigned int>(m_vertices.size());
+    m_vertices.clear();
+}
+
+void Drawer::EndFrame() {
+    Flush();
+    m_lastStats = m_stats;
+    m_stats = DrawerFrameStats();
 }
 
 glm::vec2 Drawer::ScreenToNDC(float x, float y) const {
@@ -58,6 +182,17 @@ glm::vec2 Drawer::ScreenToNDC(float x, float y) const {
 }
 
 void Drawer::DrawLine(Point start, Point end, Color color, bool dashed) {
+    m_stats.primitives++;
+    if (m_batchMode) {
+        BeginAppend();
+        PushLine({start.getx(), start.gety()}, {end.getx(), end.gety()}, color, dashed);
+        return;
+    }
+    Renderer::Get().FlushActiveBatcher();
+    m_stats.drawCalls++;
+    m_stats.bufferUploads++;
+    m_stats.vertices += 2;
+
     glm::vec2 p1 = ScreenToNDC(start.getx(), start.gety());
     glm::vec2 p2 = ScreenToNDC(end.getx(), end.gety());
 
@@ -75,7 +210,7 @@ void Drawer::DrawLine(Point start, Point end, Color color, bool dashed) {
     // 使用着色器并设置颜色（包括Alpha通道）
     defaultShader.use();
     glm::vec4 colorVec(color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f);
-    defaultShader.setVec4("u_Color", colorVec);
+    defaultShader.setVec4(m_colorUniform, colorVec);
 
     // 如果是虚线
     if (dashed) {
@@ -86,7 +221,6 @@ void Drawer::DrawLine(Point start, Point end, Color color, bool dashed) {
     // 绘制
     va.Bind();
     GLCall(glDrawArrays(GL_LINES, 0, 2));
-    VertexArray::Unbind();
 
     // 如果启用了虚线，禁用它
     if (dashed) {
@@ -95,6 +229,28 @@ void Drawer::DrawLine(Point start, Point end, Color color, bool dashed) {
 }
 
 void Drawer::DrawSquare(Region region, Color color, bool filled) {
+    m_stats.primitives++;
+    if (m_batchMode) {
+        BeginAppend();
+        glm::vec2 tl(region.getx(), region.gety());
+        glm::vec2 tr(region.getxend(), region.gety());
+        glm::vec2 br(region.getxend(), region.getyend());
+        glm::vec2 bl(region.getx(), region.getyend());
+        if (filled) {
+            PushQuad(tl, tr, br, bl, color);
+        } else {
+            PushLine(tl, tr, color, false);
+            PushLine(tr, br, color, false);
+            PushLine(br, bl, color, false);
+            PushLine(bl, tl, color, false);
+        }
+        return;
+    }
+    Renderer::Get().FlushActiveBatcher();
+    m_stats.drawCalls++;
+    m_stats.bufferUploads++;
+    m_stats.vertices += filled ? 6 : 4;
+
     glm::vec2 p1 = ScreenToNDC(region.getx(), region.gety());
     glm::vec2 p2 = ScreenToNDC(region.getxend(), region.getyend());
 
@@ -117,11 +273,10 @@ void Drawer::DrawSquare(Region region, Color color, bool filled) {
 
         defaultShader.use();
         glm::vec4 colorVec(color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f);
-        defaultShader.setVec4("u_Color", colorVec);
+        defaultShader.setVec4(m_colorUniform, colorVec);
 
         va.Bind();
         GLCall(glDrawArrays(GL_TRIANGLES, 0, 6));
-        VertexArray::Unbind();
     } else {
         // 对于线框矩形，使用4个顶点
         float vertices[] = {
@@ -137,16 +292,37 @@ void Drawer::DrawSquare(Region region, Color color, bool filled) {
 
         defaultShader.use();
         glm::vec4 colorVec(color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f);
-        defaultShader.setVec4("u_Color", colorVec);
+        defaultShader.setVec4(m_colorUniform, colorVec);
 
         va.Bind();
         GLCall(glDrawArrays(GL_LINE_LOOP, 0, 4));
-        VertexArray::Unbind();
     }
 }
 
 void Drawer::DrawCircle(Point center, float radius, Color color, bool filled) {
-    const int segments = 36; // 分段数，可以根据需要调整
+    const int segments = kCircleSegments; // 分段数，可以根据需要调整
+    m_stats.primitives++;
+    if (m_batchMode) {
+        BeginAppend();
+        glm::vec2 c(center.getx(), center.gety());
+        glm::vec2 prev(c.x + radius, c.y);
+        for (int i = 1; i <= segments; ++i) {
+            float angle = 2.0f * 3.1415926f * i / segments;
+            // 屏幕坐标Y轴向下，取负号与NDC下的绕向保持一致
+            glm::vec2 cur(c.x + cos(angle) * radius, c.y - sin(angle) * radius);
+            if (filled) {
+                PushTriangle(c, prev, cur, color);
+            } else {
+                PushLine(prev, cur, color, false);
+            }
+            prev = cur;
+        }
+        return;
+    }
+    Renderer::Get().FlushActiveBatcher();
+    m_stats.drawCalls++;
+    m_stats.bufferUploads++;
+    m_stats.vertices += filled ? segments + 2 : segments + 1;
     std::vector<float> vertices;
 
     glm::vec2 centerNDC = ScreenToNDC(center.getx(), center.gety());
@@ -177,7 +353,7 @@ void Drawer::DrawCircle(Point center, float radius, Color color, bool filled) {
     // 使用着色器并设置颜色（包括Alpha通道）
     defaultShader.use();
     glm::vec4 colorVec(color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f);
-    defaultShader.setVec4("u_Color", colorVec);
+    defaultShader.setVec4(m_colorUniform, colorVec);
 
     // 绘制
     va.Bind();
@@ -186,10 +362,29 @@ void Drawer::DrawCircle(Point center, float radius, Color color, bool filled) {
     } else {
         GLCall(glDrawArrays(GL_LINE_LOOP, 0, segments + 1));
     }
-    VertexArray::Unbind();
 }
 
 void Drawer::DrawTriangle(Point p1, Point p2, Point p3, Color color, bool filled) {
+    m_stats.primitives++;
+    if (m_batchMode) {
+        BeginAppend();
+        glm::vec2 a(p1.getx(), p1.gety());
+        glm::vec2 b(p2.getx(), p2.gety());
+        glm::vec2 c(p3.getx(), p3.gety());
+        if (filled) {
+            PushTriangle(a, b, c, color);
+        } else {
+            PushLine(a, b, color, false);
+            PushLine(b, c, color, false);
+            PushLine(c, a, color, false);
+        }
+        return;
+    }
+    Renderer::Get().FlushActiveBatcher();
+    m_stats.drawCalls++;
+    m_stats.bufferUploads++;
+    m_stats.vertices += 3;
+
     glm::vec2 v1 = ScreenToNDC(p1.getx(), p1.gety());
     glm::vec2 v2 = ScreenToNDC(p2.getx(), p2.gety());
     glm::vec2 v3 = ScreenToNDC(p3.getx(), p3.gety());
@@ -208,7 +403,7 @@ void Drawer::DrawTriangle(Point p1, Point p2, Point p3, Color color, bool filled
     // 使用着色器并设置颜色（包括Alpha通道）
     defaultShader.use();
     glm::vec4 colorVec(color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f);
-    defaultShader.setVec4("u_Color", colorVec);
+    defaultShader.setVec4(m_colorUniform, colorVec);
 
     // 绘制
     va.Bind();
@@ -217,5 +412,4 @@ void Drawer::DrawTriangle(Point p1, Point p2, Point p3, Color color, bool filled
     } else {
         GLCall(glDrawArrays(GL_LINE_LOOP, 0, 3));
     }
-    VertexArray::Unbind();
 }
\ No newline at end of file
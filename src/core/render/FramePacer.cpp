@@ -0,0 +1,167 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include "core/render/FramePacer.h"
+#include "core/render/GLBase.h"
+#include "core/render/Renderer.h"
+#include "core/Config.h"
+#include "core/configItem.h"
+
+#include <algorithm>
+#include <thread>
+
+using namespace core;
+
+namespace {
+// 睡眠精度不足（Windows 默认约 1~15ms），最后这段时间改为自旋
+constexpr auto kSpinMargin = std::chrono::microseconds(2000);
+// 阻塞等待栅栏的超时，超时后继续循环直到完成
+constexpr GLuint64 kWaitTimeoutNs = 100'000'000;
+// GPU与CPU时钟的漂移很小，每秒重新对齐一次即可
+constexpr auto kCalibrationInterval = std::chrono::seconds(1);
+
+double ToMs(std::chrono::steady_clock::duration d) {
+    return std::chrono::duration<double, std::milli>(d).count();
+}
+}
+
+FramePacer& FramePacer::Get() {
+    // 不在程序结束时析构：栅栏属于GL上下文，退出时上下文可能已经销毁
+    static FramePacer* instance = new FramePacer;
+    return *instance;
+}
+
+FramePacer::FramePacer() {
+    Config* config = Config::getInstance();
+    m_vsync = config->getBool(VERTICAL_SYNC, true);
+    m_targetFps = config->getUInt(TARGET_FPS, 0);
+    SetMaxFramesInFlight(config->getUInt(MAX_FRAMES_IN_FLIGHT, 2));
+    m_lastInput = Clock::now();
+    m_nextDeadline = m_lastInput;
+}
+
+void FramePacer::SetVSync(bool enable) {
+    m_vsync = enable;
+    glfwSwapInterval(enable ? 1 : 0);
+}
+
+unsigned int FramePacer::IssueTimestamp() {
+    if (!m_timestampChecked) {
+        m_timestampChecked = true;
+        // 空后端没有真正的时间戳
+        m_stats.gpuTimestamps = Renderer::Get().GetBackend() == Renderer::Backend::OpenGL
+            && (GLAD_GL_VERSION_3_3 || GLAD_GL_ARB_timer_query);
+    }
+    if (!m_stats.gpuTimestamps) return 0;
+
+    const auto now = Clock::now();
+    if (m_lastCalibration == Clock::time_point{} || now - m_lastCalibration >= kCalibrationInterval) {
+        GLint64 gpuNow = 0;
+        GLCall(glGetInteger64v(GL_TIMESTAMP, &gpuNow));
+        const auto cpuNow = Clock::now();
+        // 取两次CPU采样的中点，减小查询本身耗时的影响
+        const auto cpuMid = now + (cpuNow - now) / 2;
+        m_gpuClockOffsetNs = gpuNow - std::chrono::duration_cast<std::chrono::nanoseconds>(cpuMid.time_since_epoch()).count();
+        m_lastCalibration = cpuNow;
+    }
+
+    unsigned int query = 0;
+    if (m_freeQueries.empty()) {
+        GLCall(glGenQueries(1, &query));
+    } else {
+        query = m_freeQueries.back();
+        m_freeQueries.pop_back();
+    }
+    GLCall(glQueryCounter(query, GL_TIMESTAMP));
+    return query;
+}
+
+FramePacer::Clock::time_point FramePacer::GpuToCpu(uint64_t gpuNs) const {
+    const std::chrono::nanoseconds cpuNs(static_cast<int64_t>(gpuNs) - m_gpuClockOffsetNs);
+    return Clock::time_point(std::chrono::duration_cast<Clock::duration>(cpuNs));
+}
+
+void FramePacer::OnPresented(const InFlight& frame, Clock::time_point now) {
+    Clock::time_point presented = now;
+    if (frame.query) {
+        // 栅栏在查询之后，栅栏完成时结果已经可用
+        GLuint64 gpuNs = 0;
+        GLCall(glGetQueryObjectui64v(frame.query, GL_QUERY_RESULT, &gpuNs));
+        m_freeQueries.push_back(frame.query);
+        // 时钟对齐有误差，结果限制在输入时刻与发现完成的时刻之间
+        presented = std::clamp(GpuToCpu(gpuNs), frame.input, now);
+    }
+    m_stats.latencyMs = ToMs(presented - frame.input);
+    m_stats.averageLatencyMs = m_stats.averageLatencyMs == 0.0
+        ? m_stats.latencyMs
+        : m_stats.averageLatencyMs * 0.9 + m_stats.latencyMs * 0.1;
+}
+
+void FramePacer::Retire(bool wait) {
+    while (!m_inFlight.empty()) {
+        InFlight& frame = m_inFlight.front();
+        GLenum status;
+        if (wait) {
+            // 只阻塞等待最早的一帧，后面的帧只检查是否已完成
+            wait = false;
+            do {
+                GLCall(status = glClientWaitSync(frame.fence, GL_SYNC_FLUSH_COMMANDS_BIT, kWaitTimeoutNs));
+            } while (status == GL_TIMEOUT_EXPIRED);
+        } else {
+            GLCall(status = glClientWaitSync(frame.fence, 0, 0));
+            if (status == GL_TIMEOUT_EXPIRED) break;
+        }
+        // GL_WAIT_FAILED 时同样丢弃栅栏，避免永久阻塞；此时查询结果不一定可用，不再读取
+        if (status == GL_WAIT_FAILED && frame.query) {
+            m_freeQueries.push_back(frame.query);
+            frame.query = 0;
+        }
+        OnPresented(frame, Clock::now());
+        GLCall(glDeleteSync(frame.fence));
+        m_inFlight.pop_front();
+    }
+}
+
+void FramePacer::LimitFrameRate() {
+    const auto start = Clock::now();
+    if (m_vsync || m_targetFps == 0) {
+        m_nextDeadline = start;
+        m_stats.limiterSleepMs = 0.0;
+        return;
+    }
+    const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_targetFps));
+    m_nextDeadline += period;
+    // 落后超过一帧（加载、窗口拖动等）时不追赶，从现在重新计时
+    if (m_nextDeadline + period < start) {
+        m_nextDeadline = start;
+    }
+    if (m_nextDeadline - start > kSpinMargin) {
+        std::this_thread::sleep_for(m_nextDeadline - start - kSpinMargin);
+    }
+    while (Clock::now() < m_nextDeadline) {
+        std::this_thread::yield();
+    }
+    m_stats.limiterSleepMs = ToMs(Clock::now() - start);
+}
+
+void FramePacer::EndFrame() {
+    const unsigned int query = IssueTimestamp();
+    GLsync fence;
+    GLCall(fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    if (fence) {
+        m_inFlight.push_back({ fence, m_lastInput, query });
+    } else if (query) {
+        m_freeQueries.push_back(query);
+    }
+
+    // 在途帧数达到上限时等待最早的一帧，其余已完成的栅栏顺便回收
+    const auto waitStart = Clock::now();
+    Retire(m_inFlight.size() > m_maxFramesInFlight);
+    m_stats.fenceWaitMs = ToMs(Clock::now() - waitStart);
+    m_stats.framesInFlight = static_cast<unsigned int>(m_inFlight.size());
+
+    LimitFrameRate();
+}
+
+void FramePacer::OnInputPolled() {
+    m_lastInput = Clock::now();
+}
@@ -0,0 +1,30 @@
+#include "core/render/FrameStats.h"
+#include "core/render/Drawer.h"
+#include "core/render/Renderer.h"
+#include "core/render/SpriteBatch.h"
+#include "core/render/Texture.h"
+#include "core/baseItem/Font.h"
+
+using namespace core;
+
+FrameStats& FrameStats::Get() {
+    static FrameStats instance;
+    return instance;
+}
+
+void FrameStats::EndFrame() {
+    // 提交最后一个活动批处理器中的数据，再结束各批处理器的帧统计
+    Renderer::Get().FlushActiveBatcher();
+    Drawer::getInstance()->EndFrame();
+    SpriteBatch::Get().EndFrame();
+
+    FrameDrawStats stats;
+    stats.primitiveDraws = Drawer::getInstance()->GetLastFrameStats().drawCalls;
+    stats.spriteDraws = SpriteBatch::Get().GetLastFrameStats().drawCalls;
+    stats.textureDraws = Texture::TakeDrawCalls();
+    if (IFontRenderer* fontRenderer = Font::GetFontRenderer()) {
+        stats.textDraws = fontRenderer->TakeDrawCalls();
+    }
+    stats.drawCalls = stats.primitiveDraws + stats.spriteDraws + stats.textDraws + stats.textureDraws;
+    m_last = stats;
+}
@@ -0,0 +1,133 @@
+#include <glad/glad.h>
+#include "core/render/GLStateCache.h"
+#include "core/render/GLBase.h"
+
+using namespace core;
+
+GLStateCache& GLStateCache::Get() {
+    static GLStateCache instance;
+    return instance;
+}
+
+GLStateCache::GLStateCache() {
+    Invalidate();
+}
+
+bool GLStateCache::Change(unsigned int& cached, unsigned int value) {
+    if (cached == value) {
+        m_stats.elided++;
+        return false;
+    }
+    cached = value;
+    m_stats.issued++;
+    return true;
+}
+
+void GLStateCache::UseProgram(unsigned int program) {
+    if (Change(m_program, program)) {
+        GLCall(glUseProgram(program));
+    }
+}
+
+void GLStateCache::BindVertexArray(unsigned int vao) {
+    if (Change(m_vao, vao)) {
+        GLCall(glBindVertexArray(vao));
+    }
+}
+
+void GLStateCache::BindBuffer(unsigned int target, unsigned int buffer) {
+    if (target != GL_ARRAY_BUFFER) {
+        m_stats.issued++;
+        GLCall(glBindBuffer(target, buffer));
+        return;
+    }
+    if (Change(m_arrayBuffer, buffer)) {
+        GLCall(glBindBuffer(GL_ARRAY_BUFFER, buffer));
+    }
+}
+
+void GLStateCache::ActiveTexture(unsigned int unit) {
+    if (Change(m_activeUnit, unit)) {
+        GLCall(glActiveTexture(GL_TEXTURE0 + unit));
+    }
+}
+
+void GLStateCache::BindTexture(unsigned int target, unsigned int texture) {
+    if (target != GL_TEXTURE_2D || m_activeUnit >= MaxTextureUnits) {
+        m_stats.issued++;
+        GLCall(glBindTexture(target, texture));
+        return;
+    }
+    if (Change(m_textures[m_activeUnit], texture)) {
+        GLCall(glBindTexture(GL_TEXTURE_2D, texture));
+    }
+}
+
+void GLStateCache::BindTexture(unsigned int unit, unsigned int target, unsigned int texture) {
+    ActiveTexture(unit);
+    BindTexture(target, texture);
+}
+
+void GLStateCache::SetBlend(bool enable) {
+    if (Change(m_blend, enable ? 1u : 0u)) {
+        if (enable) {
+            GLCall(glEnable(GL_BLEND));
+        } else {
+            GLCall(glDisable(GL_BLEND));
+        }
+    }
+}
+
+void GLStateCache::BlendFunc(unsigned int src, unsigned int dst) {
+    if (m_blendSrc == src && m_blendDst == dst) {
+        m_stats.elided++;
+        return;
+    }
+    m_blendSrc = src;
+    m_blendDst = dst;
+    m_stats.issued++;
+    GLCall(glBlendFunc(src, dst));
+}
+
+void GLStateCache::Viewport(int x, int y, int width, int height) {
+    const std::array<int, 4> viewport = { x, y, width, height };
+    if (m_viewportKnown && m_viewport == viewport) {
+        m_stats.elided++;
+        return;
+    }
+    m_viewport = viewport;
+    m_viewportKnown = true;
+    m_stats.issued++;
+    GLCall(glViewport(x, y, width, height));
+}
+
+void GLStateCache::OnProgramDeleted(unsigned int program) {
+    // 正在使用的程序删除后仍保持使用，直到切换；ID可能被新程序复用，因此置为未知
+    if (m_program == program) m_program = Unknown;
+}
+
+void GLStateCache::OnVertexArrayDeleted(unsigned int vao) {
+    if (m_vao == vao) m_vao = 0;
+}
+
+void GLStateCache::OnBufferDeleted(unsigned int buffer) {
+    if (m_arrayBuffer == buffer) m_arrayBuffer = 0;
+}
+
+void GLStateCache::OnTextureDeleted(unsigned int texture) {
+    for (auto& bound : m_textures) {
+        if (bound == texture) bound = 0;
+    }
+}
+
+void GLStateCache::Invalidate() {
+    m_program = Unknown;
+    m_vao = Unknown;
+    m_arrayBuffer = Unknown;
+    m_activeUnit = Unknown;
+    m_textures.fill(Unknown);
+    m_blend = Unknown;
+    m_blendSrc = Unknown;
+    m_blendDst = Unknown;
+    m_viewportKnown = false;
+}
@@ -0,0 +1,127 @@
+#include "core/render/GlyphAtlas.h"
+#include "core/log.h"
+
+using namespace core;
+
+GlyphAtlas::GlyphAtlas(int pageSize, uint32_t maxPages, int padding)
+    : pageSize(pageSize), maxPages(maxPages > 0 ? maxPages : 1), padding(padding) {
+}
+
+bool GlyphAtlas::AllocateInPage(Page& page, int width, int height, int& x, int& y) {
+    // 优先选择高度最接近的货架，且不超过字形高度的1.5倍，减少浪费
+    Shelf* best = nullptr;
+    Shelf* fallback = nullptr;
+    for (auto& shelf : page.shelves) {
+        if (shelf.height < height || shelf.cursorX + width > pageSize) continue;
+        if (!fallback || shelf.height < fallback->height) fallback = &shelf;
+        if (shelf.height <= height + height / 2 && (!best || shelf.height < best->height)) best = &shelf;
+    }
+    Shelf* target = best;
+    if (!target) {
+        if (page.nextY + height <= pageSize) {
+            // 开一个新货架
+            page.shelves.push_back({page.nextY, height, 0});
+            page.nextY += height;
+            target = &page.shelves.back();
+        } else {
+            target = fallback;
+        }
+    }
+    if (!target) return false;
+
+    x = target->cursorX;
+    y = target->y;
+    target->cursorX += width;
+    return true;
+}
+
+void GlyphAtlas::ResetPage(Page& page) {
+    page.shelves.clear();
+    page.nextY = 0;
+    page.generation++;
+}
+
+bool GlyphAtlas::Allocate(int width, int height, Allocation& out) {
+    int paddedWidth = width + padding * 2;
+    int paddedHeight = height + padding * 2;
+    if (width <= 0 || height <= 0 || paddedWidth > pageSize || paddedHeight > pageSize) {
+        Log << Level::Warn << "GlyphAtlas::Allocate() glyph " << width << "x" << height << " does not fit in atlas page" << op::endl;
+        return false;
+    }
+
+    int x = 0, y = 0;
+    out.newPage = false;
+    // 先尝试已有页
+    for (uint32_t i = 0; i < pages.size(); ++i) {
+        if (AllocateInPage(pages[i], paddedWidth, paddedHeight, x, y)) {
+            out.page = i;
+            out.generation = pages[i].generation;
+            out.x = x + padding;
+            out.y = y + padding;
+            Touch(i);
+            return true;
+        }
+    }
+
+    uint32_t target = 0;
+    if (pages.size() < maxPages) {
+        // 新建一页
+        pages.emplace_back();
+        target = static_cast<uint32_t>(pages.size() - 1);
+        out.newPage = true;
+    } else {
+        // 所有页已满，驱逐最久未使用且未被固定的页
+        bool found = false;
+        for (uint32_t i = 0; i < pages.size(); ++i) {
+            if (pinDepth > 0 && pages[i].lastUse >= pinClock) continue;
+            if (!found || pages[i].lastUse < pages[target].lastUse) {
+                target = i;
+                found = true;
+            }
+        }
+        if (!found) {
+            Log << Level::Warn << "GlyphAtlas::Allocate() all " << pages.size() << " pages are pinned by the current text run" << op::endl;
+            return false;
+        }
+        if (onEvict) onEvict(target);
+        ResetPage(pages[target]);
+        evictions++;
+        Log << Level::Debug << "GlyphAtlas evicted page " << target << " (generation " << pages[target].generation << ")" << op::endl;
+    }
+
+    if (!AllocateInPage(pages[target], paddedWidth, paddedHeight, x, y)) {
+        return false;
+    }
+    out.page = target;
+    out.generation = pages[target].generation;
+    out.x = x + padding;
+    out.y = y + padding;
+    Touch(target);
+    return true;
+}
+
+bool GlyphAtlas::IsResident(uint32_t page, uint32_t generation) const {
+    return page < pages.size() && pages[page].generation == generation;
+}
+
+void GlyphAtlas::Touch(uint32_t page) {
+    if (page < pages.size()) {
+        pages[page].lastUse = ++clock;
+    }
+}
+
+void GlyphAtlas::BeginPin() {
+    if (pinDepth++ == 0) {
+        pinClock = clock + 1;
+    }
+}
+
+void GlyphAtlas::EndPin() {
+    if (pinDepth > 0) pinDepth--;
+}
+
+void GlyphAtlas::Clear() {
+    for (auto& page : pages) {
+        ResetPage(page);
+    }
+}
@@ -0,0 +1,438 @@
+#include <glad/glad.h>
+#include "core/render/NullBackend.h"
+#include "core/render/GLStateCache.h"
+#include "core/render/Renderer.h"
+#include "core/log.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace core;
+
+namespace {
+
+struct ProgramInfo {
+    std::vector<GLuint> shaders;
+    std::vector<std::string> uniforms; // 下标 + 1 作为uniform位置
+};
+
+// 桩函数共享的状态：对象ID、查询需要的绑定与着色器源码
+struct NullState {
+    NullBackendStats stats;
+    GLuint nextId = 1;
+    GLuint vertexArray = 0;
+    GLuint arrayBuffer = 0;
+    std::vector<unsigned char> mapped;
+    std::unordered_map<GLuint, std::string> shaderSources;
+    std::unordered_map<GLuint, ProgramInfo> programs;
+};
+
+NullState& State() {
+    static NullState state;
+    return state;
+}
+
+size_t PixelBytes(GLenum format, GLenum type) {
+    size_t channels = 4;
+    switch (format) {
+    case GL_RED: channels = 1; break;
+    case GL_RG: channels = 2; break;
+    case GL_RGB: case GL_BGR: channels = 3; break;
+    default: break;
+    }
+    size_t size = 1;
+    switch (type) {
+    case GL_UNSIGNED_SHORT: case GL_SHORT: case GL_HALF_FLOAT: size = 2; break;
+    case GL_UNSIGNED_INT: case GL_INT: case GL_FLOAT: size = 4; break;
+    default: break;
+    }
+    return channels * size;
+}
+
+// 从GLSL源码中提取 "uniform <类型> <名称>" 声明，供活动uniform查询使用
+void CollectUniforms(const std::string& source, std::vector<std::string>& out) {
+    size_t pos = 0;
+    while ((pos = source.find("uniform", pos)) != std::string::npos) {
+        const bool startsWord = pos == 0 || !(std::isalnum(static_cast<unsigned char>(source[pos - 1])) || source[pos - 1] == '_');
+        pos += 7;
+        if (!startsWord || pos >= source.size() || !std::isspace(static_cast<unsigned char>(source[pos]))) continue;
+        auto skipSpace = [&]() { while (pos < source.size() && std::isspace(static_cast<unsigned char>(source[pos]))) pos++; };
+        auto readWord = [&]() {
+            size_t start = pos;
+            while (pos < source.size() && (std::isalnum(static_cast<unsigned char>(source[pos])) || source[pos] == '_')) pos++;
+            return source.substr(start, pos - start);
+        };
+        skipSpace();
+        readWord(); // 类型
+        skipSpace();
+        std::string name = readWord();
+        if (!name.empty() && std::find(out.begin(), out.end(), name) == out.end()) {
+            out.push_back(std::move(name));
+        }
+    }
+}
+
+// ---- 桩函数 ----
+
+void APIENTRY NullNoop() {}
+void APIENTRY NullTarget(GLenum) {}
+void APIENTRY NullObject(GLuint) {}
+void APIENTRY NullParameteri(GLenum, GLenum, GLint) {}
+void APIENTRY NullPixelStorei(GLenum, GLint) {}
+void APIENTRY NullDelete(GLsizei, const GLuint*) {}
+void APIENTRY NullDeleteSync(GLsync) {}
+void APIENTRY NullVertexAttribPointer(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*) {}
+void APIENTRY NullCopyBufferSubData(GLenum, GLenum, GLintptr, GLintptr, GLsizeiptr) {}
+void APIENTRY NullProgramParameteri(GLuint, GLenum, GLint) {}
+void APIENTRY NullProgramBinary(GLuint, GLenum, const void*, GLsizei) {}
+void APIENTRY NullBeginQuery(GLenum, GLuint) {}
+void APIENTRY NullQueryCounter(GLuint, GLenum) {}
+void APIENTRY NullClearColor(GLfloat, GLfloat, GLfloat, GLfloat) {}
+void APIENTRY NullClear(GLbitfield) {}
+void APIENTRY NullLineStipple(GLint, GLushort) {}
+
+GLenum APIENTRY NullGetError() { return GL_NO_ERROR; }
+
+const GLubyte* APIENTRY NullGetString(GLenum name) {
+    const char* value = "";
+    switch (name) {
+    case GL_VENDOR: value = "PlaneWeaver"; break;
+    case GL_RENDERER: value = "Null"; break;
+    case GL_VERSION: value = "3.3.0 Null"; break;
+    case GL_SHADING_LANGUAGE_VERSION: value = "3.30"; break;
+    default: break;
+    }
+    return reinterpret_cast<const GLubyte*>(value);
+}
+
+const GLubyte* APIENTRY NullGetStringi(GLenum, GLuint) { return nullptr; }
+
+void APIENTRY NullGetIntegerv(GLenum pname, GLint* data) {
+    if (!data) return;
+    switch (pname) {
+    case GL_VERTEX_ARRAY_BINDING: *data = static_cast<GLint>(State().vertexArray); break;
+    case GL_ARRAY_BUFFER_BINDING: *data = static_cast<GLint>(State().arrayBuffer); break;
+    case GL_MAX_TEXTURE_SIZE: *data = 16384; break;
+    default: *data = 0; break;
+    }
+}
+
+void APIENTRY NullGetInteger64v(GLenum, GLint64* data) { if (data) *data = 0; }
+
+void APIENTRY NullGen(GLsizei n, GLuint* ids) {
+    NullState& state = State();
+    for (GLsizei i = 0; i < n; ++i) {
+        ids[i] = state.nextId++;
+    }
+    state.stats.objectsCreated += static_cast<unsigned long long>(n);
+}
+
+GLuint APIENTRY NullCreateShader(GLenum) {
+    State().stats.objectsCreated++;
+    return State().nextId++;
+}
+
+GLuint APIENTRY NullCreateProgram() {
+    NullState& state = State();
+    state.stats.objectsCreated++;
+    GLuint id = state.nextId++;
+    state.programs[id];
+    return id;
+}
+
+void APIENTRY NullShaderSource(GLuint shader, GLsizei count, const GLchar* const* strings, const GLint* lengths) {
+    std::string& source = State().shaderSources[shader];
+    source.clear();
+    for (GLsizei i = 0; i < count; ++i) {
+        if (lengths && lengths[i] >= 0) source.append(strings[i], static_cast<size_t>(lengths[i]));
+        else source.append(strings[i]);
+    }
+}
+
+void APIENTRY NullDeleteShader(GLuint shader) { State().shaderSources.erase(shader); }
+void APIENTRY NullDeleteProgram(GLuint program) { State().programs.erase(program); }
+
+void APIENTRY NullAttachShader(GLuint program, GLuint shader) {
+    State().programs[program].shaders.push_back(shader);
+}
+
+void APIENTRY NullDetachShader(GLuint program, GLuint shader) {
+    std::vector<GLuint>& shaders = State().programs[program].shaders;
+    shaders.erase(std::remove(shaders.begin(), shaders.end(), shader), shaders.end());
+}
+
+void APIENTRY NullLinkProgram(GLuint program) {
+    NullState& state = State();
+    ProgramInfo& info = state.programs[program];
+    info.uniforms.clear();
+    for (GLuint shader : info.shaders) {
+        auto it = state.shaderSources.find(shader);
+        if (it != state.shaderSources.end()) CollectUniforms(it->second, info.uniforms);
+    }
+}
+
+void APIENTRY NullGetShaderiv(GLuint, GLenum pname, GLint* params) {
+    if (params) *params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+}
+
+void APIENTRY NullGetProgramiv(GLuint program, GLenum pname, GLint* params) {
+    if (!params) return;
+    const ProgramInfo& info = State().programs[program];
+    switch (pname) {
+    case GL_LINK_STATUS: case GL_VALIDATE_STATUS: *params = GL_TRUE; break;
+    case GL_ACTIVE_UNIFORMS: *params = static_cast<GLint>(info.uniforms.size()); break;
+    case GL_ACTIVE_UNIFORM_MAX_LENGTH: {
+        size_t length = 1;
+        for (const auto& name : info.uniforms) length = std::max(length, name.size() + 1);
+        *params = static_cast<GLint>(length);
+        break;
+    }
+    default: *params = 0; break;
+    }
+}
+
+// 没有可保存的程序二进制：ShaderProgramCache 照常编译
+void APIENTRY NullGetProgramBinary(GLuint, GLsizei, GLsizei* length, GLenum* format, void*) {
+    if (length) *length = 0;
+    if (format) *format = 0;
+}
+
+void APIENTRY NullGetInfoLog(GLuint, GLsizei bufSize, GLsizei* length, GLchar* infoLog) {
+    if (length) *length = 0;
+    if (infoLog && bufSize > 0) infoLog[0] = '\0';
+}
+
+void APIENTRY NullGetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size,
+                                   GLenum* type, GLchar* name) {
+    const ProgramInfo& info = State().programs[program];
+    std::string value = index < info.uniforms.size() ? info.uniforms[index] : std::string();
+    GLsizei written = 0;
+    if (name && bufSize > 0) {
+        written = static_cast<GLsizei>(std::min<size_t>(value.size(), static_cast<size_t>(bufSize - 1)));
+        std::memcpy(name, value.data(), static_cast<size_t>(written));
+        name[written] = '\0';
+    }
+    if (length) *length = written;
+    if (size) *size = 1;
+    if (type) *type = GL_FLOAT;
+}
+
+GLint APIENTRY NullGetUniformLocation(GLuint program, const GLchar* name) {
+    const ProgramInfo& info = State().programs[program];
+    auto it = std::find(info.uniforms.begin(), info.uniforms.end(), name);
+    return it == info.uniforms.end() ? -1 : static_cast<GLint>(it - info.uniforms.begin());
+}
+
+void APIENTRY NullGetUniformfv(GLuint, GLint, GLfloat* params) { if (params) *params = 0.0f; }
+void APIENTRY NullGetUniformiv(GLuint, GLint, GLint* params) { if (params) *params = 0; }
+void APIENTRY NullGetUniformuiv(GLuint, GLint, GLuint* params) { if (params) *params = 0; }
+void APIENTRY NullGetVertexAttribiv(GLuint, GLenum, GLint* params) { if (params) *params = 0; }
+void APIENTRY NullGetVertexAttribPointerv(GLuint, GLenum, void** pointer) { if (pointer) *pointer = nullptr; }
+void APIENTRY NullGetBufferSubData(GLenum, GLintptr, GLsizeiptr size, void* data) {
+    if (data && size > 0) std::memset(data, 0, static_cast<size_t>(size));
+}
+
+// 计时查询立即可用，耗时为 0
+void APIENTRY NullGetQueryObjectiv(GLuint, GLenum pname, GLint* params) {
+    if (params) *params = pname == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : 0;
+}
+void APIENTRY NullGetQueryObjectui64v(GLuint, GLenum, GLuint64* params) { if (params) *params = 0; }
+
+void APIENTRY NullUniform1i(GLint, GLint) { State().stats.uniformUploads++; }
+void APIENTRY NullUniform1f(GLint, GLfloat) { State().stats.uniformUploads++; }
+void APIENTRY NullUniform2f(GLint, GLfloat, GLfloat) { State().stats.uniformUploads++; }
+void APIENTRY NullUniform3f(GLint, GLfloat, GLfloat, GLfloat) { State().stats.uniformUploads++; }
+void APIENTRY NullUniform4f(GLint, GLfloat, GLfloat, GLfloat, GLfloat) { State().stats.uniformUploads++; }
+void APIENTRY NullUniformMatrix4fv(GLint, GLsizei, GLboolean, const GLfloat*) { State().stats.uniformUploads++; }
+
+void APIENTRY NullBindBuffer(GLenum target, GLuint buffer) {
+    if (target == GL_ARRAY_BUFFER) State().arrayBuffer = buffer;
+    State().stats.stateChanges++;
+}
+void APIENTRY NullBindVertexArray(GLuint array) {
+    State().vertexArray = array;
+    State().stats.stateChanges++;
+}
+void APIENTRY NullBindTexture(GLenum, GLuint) { State().stats.stateChanges++; }
+void APIENTRY NullUseProgram(GLuint) { State().stats.stateChanges++; }
+void APIENTRY NullEnum(GLenum) { State().stats.stateChanges++; }
+void APIENTRY NullBlendFunc(GLenum, GLenum) { State().stats.stateChanges++; }
+void APIENTRY NullViewport(GLint, GLint, GLsizei, GLsizei) { State().stats.stateChanges++; }
+
+void APIENTRY NullBufferData(GLenum, GLsizeiptr size, const void* data, GLenum) {
+    // 只分配存储（data为空）不算上传
+    if (!data) return;
+    State().stats.bufferUploads++;
+    State().stats.bufferUploadBytes += static_cast<unsigned long long>(size);
+}
+void APIENTRY NullBufferSubData(GLenum, GLintptr, GLsizeiptr size, const void*) {
+    State().stats.bufferUploads++;
+    State().stats.bufferUploadBytes += static_cast<unsigned long long>(size);
+}
+void APIENTRY NullBufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield) {
+    NullBufferData(target, size, data, 0);
+}
+void* APIENTRY NullMapBufferRange(GLenum, GLintptr, GLsizeiptr length, GLbitfield) {
+    NullState& state = State();
+    state.mapped.resize(static_cast<size_t>(std::max<GLsizeiptr>(length, 0)));
+    return state.mapped.data();
+}
+GLboolean APIENTRY NullUnmapBuffer(GLenum) {
+    NullState& state = State();
+    state.stats.bufferUploads++;
+    state.stats.bufferUploadBytes += state.mapped.size();
+    return GL_TRUE;
+}
+
+void APIENTRY NullTexImage2D(GLenum, GLint, GLint, GLsizei width, GLsizei height, GLint, GLenum format, GLenum type,
+                             const void* pixels) {
+    if (!pixels) return;
+    State().stats.textureUploads++;
+    State().stats.textureUploadBytes += static_cast<unsigned long long>(width) * height * PixelBytes(format, type);
+}
+void APIENTRY NullTexSubImage2D(GLenum, GLint, GLint, GLint, GLsizei width, GLsizei height, GLenum format, GLenum type,
+                                const void*) {
+    State().stats.textureUploads++;
+    State().stats.textureUploadBytes += static_cast<unsigned long long>(width) * height * PixelBytes(format, type);
+}
+
+// 栅栏立即完成：帧节奏控制不会阻塞
+GLsync APIENTRY NullFenceSync(GLenum, GLbitfield) {
+    State().stats.objectsCreated++;
+    static char fence;
+    return reinterpret_cast<GLsync>(&fence);
+}
+GLenum APIENTRY NullClientWaitSync(GLsync, GLbitfield, GLuint64) { return GL_ALREADY_SIGNALED; }
+
+void APIENTRY NullDrawArrays(GLenum, GLint, GLsizei count) {
+    State().stats.drawCalls++;
+    State().stats.vertices += static_cast<unsigned long long>(count);
+}
+void APIENTRY NullDrawElements(GLenum, GLsizei count, GLenum, const void*) {
+    State().stats.drawCalls++;
+    State().stats.vertices += static_cast<unsigned long long>(count);
+}
+
+template<typename Fn>
+void* Entry(Fn fn) { return reinterpret_cast<void*>(fn); }
+
+void* NullGetProcAddress(const char* name) {
+    static const std::unordered_map<std::string, void*> table = {
+        { "glGetError", Entry(&NullGetError) },
+        { "glGetString", Entry(&NullGetString) },
+        { "glGetStringi", Entry(&NullGetStringi) },
+        { "glGetIntegerv", Entry(&NullGetIntegerv) },
+        { "glGetInteger64v", Entry(&NullGetInteger64v) },
+        { "glGenBuffers", Entry(&NullGen) },
+        { "glGenTextures", Entry(&NullGen) },
+        { "glGenVertexArrays", Entry(&NullGen) },
+        { "glGenQueries", Entry(&NullGen) },
+        { "glGenFramebuffers", Entry(&NullGen) },
+        { "glCreateShader", Entry(&NullCreateShader) },
+        { "glCreateProgram", Entry(&NullCreateProgram) },
+        { "glShaderSource", Entry(&NullShaderSource) },
+        { "glDeleteShader", Entry(&NullDeleteShader) },
+        { "glDeleteProgram", Entry(&NullDeleteProgram) },
+        { "glAttachShader", Entry(&NullAttachShader) },
+        { "glLinkProgram", Entry(&NullLinkProgram) },
+        { "glGetShaderiv", Entry(&NullGetShaderiv) },
+        { "glGetProgramiv", Entry(&NullGetProgramiv) },
+        { "glGetShaderInfoLog", Entry(&NullGetInfoLog) },
+        { "glGetProgramInfoLog", Entry(&NullGetInfoLog) },
+        { "glGetActiveUniform", Entry(&NullGetActiveUniform) },
+        { "glGetUniformLocation", Entry(&NullGetUniformLocation) },
+        { "glGetUniformfv", Entry(&NullGetUniformfv) },
+        { "glGetUniformiv", Entry(&NullGetUniformiv) },
+        { "glGetUniformuiv", Entry(&NullGetUniformuiv) },
+        { "glGetVertexAttribiv", Entry(&NullGetVertexAttribiv) },
+        { "glGetVertexAttribPointerv", Entry(&NullGetVertexAttribPointerv) },
+        { "glGetBufferSubData", Entry(&NullGetBufferSubData) },
+        { "glUniform1i", Entry(&NullUniform1i) },
+        { "glUniform1f", Entry(&NullUniform1f) },
+        { "glUniform2f", Entry(&NullUniform2f) },
+        { "glUniform3f", Entry(&NullUniform3f) },
+        { "glUniform4f", Entry(&NullUniform4f) },
+        { "glUniformMatrix4fv", Entry(&NullUniformMatrix4fv) },
+        { "glBindBuffer", Entry(&NullBindBuffer) },
+        { "glBindVertexArray", Entry(&NullBindVertexArray) },
+        { "glBindTexture", Entry(&NullBindTexture) },
+        { "glUseProgram", Entry(&NullUseProgram) },
+        { "glActiveTexture", Entry(&NullEnum) },
+        { "glEnable", Entry(&NullEnum) },
+        { "glDisable", Entry(&NullEnum) },
+        { "glBlendEquation", Entry(&NullEnum) },
+        { "glBlendFunc", Entry(&NullBlendFunc) },
+        { "glViewport", Entry(&NullViewport) },
+        { "glBufferData", Entry(&NullBufferData) },
+        { "glBufferSubData", Entry(&NullBufferSubData) },
+        { "glMapBufferRange", Entry(&NullMapBufferRange) },
+        { "glUnmapBuffer", Entry(&NullUnmapBuffer) },
+        { "glTexImage2D", Entry(&NullTexImage2D) },
+        { "glTexSubImage2D", Entry(&NullTexSubImage2D) },
+        { "glFenceSync", Entry(&NullFenceSync) },
+        { "glClientWaitSync", Entry(&NullClientWaitSync) },
+        { "glDrawArrays", Entry(&NullDrawArrays) },
+        { "glDrawElements", Entry(&NullDrawElements) },
+        { "glScissor", Entry(&NullViewport) },
+        { "glBufferStorage", Entry(&NullBufferStorage) },
+        { "glGetProgramBinary", Entry(&NullGetProgramBinary) },
+        { "glGetQueryObjectiv", Entry(&NullGetQueryObjectiv) },
+        { "glGetQueryObjectui64v", Entry(&NullGetQueryObjectui64v) },
+        { "glDetachShader", Entry(&NullDetachShader) },
+        // 以下调用不影响计数，但签名必须与真实函数一致
+        { "glCompileShader", Entry(&NullObject) },
+        { "glValidateProgram", Entry(&NullObject) },
+        { "glEnableVertexAttribArray", Entry(&NullObject) },
+        { "glDisableVertexAttribArray", Entry(&NullObject) },
+        { "glGenerateMipmap", Entry(&NullTarget) },
+        { "glEndQuery", Entry(&NullTarget) },
+        { "glTexParameteri", Entry(&NullParameteri) },
+        { "glPixelStorei", Entry(&NullPixelStorei) },
+        { "glDeleteBuffers", Entry(&NullDelete) },
+        { "glDeleteTextures", Entry(&NullDelete) },
+        { "glDeleteVertexArrays", Entry(&NullDelete) },
+        { "glDeleteQueries", Entry(&NullDelete) },
+        { "glDeleteFramebuffers", Entry(&NullDelete) },
+        { "glDeleteSync", Entry(&NullDeleteSync) },
+        { "glVertexAttribPointer", Entry(&NullVertexAttribPointer) },
+        { "glCopyBufferSubData", Entry(&NullCopyBufferSubData) },
+        { "glProgramParameteri", Entry(&NullProgramParameteri) },
+        { "glProgramBinary", Entry(&NullProgramBinary) },
+        { "glBeginQuery", Entry(&NullBeginQuery) },
+        { "glQueryCounter", Entry(&NullQueryCounter) },
+        { "glClearColor", Entry(&NullClearColor) },
+        { "glClear", Entry(&NullClear) },
+        { "glLineStipple", Entry(&NullLineStipple) },
+        { "glFinish", Entry(&NullNoop) },
+        { "glFlush", Entry(&NullNoop) },
+    };
+    auto it = table.find(name);
+    // 没有桩函数的入口保持为空指针：新增的GL调用在空后端上立即崩溃，而不是静默地走错签名
+    return it != table.end() ? it->second : nullptr;
+}
+
+} // namespace
+
+bool NullBackend::Initialize() {
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(&NullGetProcAddress))) {
+        Log << Level::Error << "NullBackend::Initialize() failed to load stub entry points" << op::endl;
+        return false;
+    }
+    Renderer::Get().SetBackend(Renderer::Backend::Null);
+    GLStateCache::Get().Invalidate();
+    ResetStats();
+    Log << Level::Info << "NullBackend initialized" << op::endl;
+    return true;
+}
+
+const NullBackendStats& NullBackend::GetStats() {
+    return State().stats;
+}
+
+void NullBackend::ResetStats() {
+    State().stats = NullBackendStats();
+}
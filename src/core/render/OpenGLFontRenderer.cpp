@@ -1,6 +1,10 @@
-#include "OpenGLFontRenderer.h"
+#include "core/render/OpenGLFontRenderer.h"
+#include "core/render/GLStateCache.h"
+#include "core/render/Renderer.h"
 #include "core/render/Shader.h"
 #include <glad/glad.h>
+#include <algorithm>
+#include <cstddef>
 #include <iostream>
 
 using namespace core;
@@ -23,12 +27,54 @@ out vec4 color;
 uniform sampler2D text;
 uniform vec3 textColor;
 uniform float alphaMultiplier;
+uniform int distanceField;
 void main() {
-    float alpha = texture(text, TexCoords).r * alphaMultiplier;
-    color = vec4(textColor, alpha);
+    float value = texture(text, TexCoords).r;
+    // 距离场：0.5 为字形边缘，按屏幕空间导数抗锯齿，任意缩放都保持清晰
+    float width = fwidth(value);
+    float alpha = distanceField != 0 ? smoothstep(0.5 - width, 0.5 + width, value) : value;
+    color = vec4(textColor, alpha * alphaMultiplier);
 }
 )";
 
+// 批处理着色器：颜色随顶点传入，不同颜色的字符串可以合并到同一次绘制
+static const std::string batchVertexSrc = R"(
+#version 330 core
+layout(location = 0) in vec4 vertex;
+layout(location = 1) in vec4 vertexColor;
+layout(location = 2) in float vertexDistanceField;
+out vec2 TexCoords;
+out vec4 TextColor;
+flat out float DistanceField;
+uniform mat4 projection;
+void main() {
+    gl_Position = projection * vec4(vertex.xy, 0.0, 1.0);
+    TexCoords = vertex.zw;
+    TextColor = vertexColor;
+    DistanceField = vertexDistanceField;
+}
+)";
+
+static const std::string batchFragmentSrc = R"(
+#version 330 core
+in vec2 TexCoords;
+in vec4 TextColor;
+flat in float DistanceField;
+out vec4 color;
+uniform sampler2D text;
+void main() {
+    float value = texture(text, TexCoords).r;
+    // 同一批中覆盖率字形与距离场字形可以混合
+    float width = fwidth(value);
+    float alpha = DistanceField > 0.5 ? smoothstep(0.5 - width, 0.5 + width, value) : value;
+    color = vec4(TextColor.rgb, alpha * TextColor.a);
+}
+)";
+
+static unsigned char ToByte(float v) {
+    return static_cast<unsigned char>(std::clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
 OpenGLFontRenderer::OpenGLFontRenderer() {}
 
 OpenGLFontRenderer::~OpenGLFontRenderer() {
@@ -37,8 +83,9 @@ OpenGLFontRenderer::~OpenGLFontRenderer() {
 
 bool OpenGLFontRenderer::Initialize(void* windowHandle) {
     m_window = reinterpret_cast<GLFWwindow*>(windowHandle);
-    // 依赖外部已加载 glad 并且已有当前 OpenGL context
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+    // 依赖外部已加载 glad 并且已有当前 OpenGL context；空后端已装载桩函数，不能重新加载
+    const bool nullBackend = core::Renderer::Get().GetBackend() == core::Renderer::Backend::Null;
+    if (!nullBackend && !gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
         std::cerr << "Failed to initialize GL loader in OpenGLFontRenderer" << std::endl;
         return false;
     }
@@ -49,27 +96,47 @@ bool OpenGLFontRenderer::Initialize(void* windowHandle) {
     glGenVertexArrays(1, &m_vao);
     glGenBuffers(1, &m_vbo);
 
-    glBindVertexArray(m_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    GLStateCache::Get().BindVertexArray(m_vao);
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, m_vbo);
     glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, nullptr, GL_DYNAMIC_DRAW);
 
     // layout location 0: vec4 (x,y, u, v)
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, 0);
+    GLStateCache::Get().BindVertexArray(0);
+
+    // 批处理资源
+    m_batchShader.init(batchVertexSrc, batchFragmentSrc);
+    glGenVertexArrays(1, &m_batchVao);
+    glGenBuffers(1, &m_batchVbo);
+    GLStateCache::Get().BindVertexArray(m_batchVao);
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, m_batchVbo);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, x));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(TextVertex), (void*)offsetof(TextVertex, r));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, distanceField));
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, 0);
+    GLStateCache::Get().BindVertexArray(0);
+
+    // 驱逐图集页之前先提交仍引用它的文字
+    m_atlas.SetEvictCallback([this](uint32_t) { FlushText(); });
 
     m_initialized = true;
-    // 标记当前 renderer 为 OpenGL，这样 GLBase 的 GLCall 会启用错误检查路径
-    core::Renderer::Get().SetBackend(core::Renderer::Backend::OpenGL);
+    // 标记当前 renderer 为 OpenGL，这样 GLBase 的 GLCall 会启用错误检查路径（空后端下保持不变）
+    if (!nullBackend) {
+        core::Renderer::Get().SetBackend(core::Renderer::Backend::OpenGL);
+    }
     return true;
 }
 
 IFontRenderer::TextureId OpenGLFontRenderer::CreateGlyphTexture(int width, int height, const unsigned char* data) {
     GLuint tex = 0;
     glGenTextures(1, &tex);
-    glBindTexture(GL_TEXTURE_2D, tex);
+    GLStateCache::Get().BindTexture(GL_TEXTURE_2D, tex);
     // 单通道
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, data);
@@ -78,8 +145,6 @@ IFontRenderer::TextureId OpenGLFontRenderer::CreateGlyphTexture(int width, int h
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    glBindTexture(GL_TEXTURE_2D, 0);
     return static_cast<TextureId>(tex);
 }
 
@@ -87,50 +152,256 @@ void OpenGLFontRenderer::DeleteTexture(TextureId id) {
     GLuint tex = static_cast<GLuint>(id);
     if (tex != 0) {
         glDeleteTextures(1, &tex);
+        GLStateCache::Get().OnTextureDeleted(tex);
     }
 }
 
+bool OpenGLFontRenderer::AllocateGlyph(int width, int height, const unsigned char* data, AtlasSlot& outSlot) {
+    GlyphAtlas::Allocation alloc;
+    if (!m_atlas.Allocate(width, height, alloc)) {
+        return false;
+    }
+    const int pageSize = m_atlas.GetPageSize();
+    if (alloc.page >= m_atlasTextures.size()) {
+        m_atlasTextures.resize(alloc.page + 1, 0);
+    }
+    if (alloc.newPage || m_atlasTextures[alloc.page] == 0) {
+        // 新页：创建单通道纹理，内容由每个字形连同边距一起写入
+        GLuint tex = 0;
+        glGenTextures(1, &tex);
+        GLStateCache::Get().BindTexture(GL_TEXTURE_2D, tex);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, pageSize, pageSize, 0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        m_atlasTextures[alloc.page] = tex;
+    }
+
+    // 连同四周的空白边距一起上传，避免线性过滤时采样到相邻字形或旧数据
+    const int padding = m_atlas.GetPadding();
+    const int paddedWidth = width + padding * 2;
+    const int paddedHeight = height + padding * 2;
+    m_uploadScratch.assign(static_cast<size_t>(paddedWidth) * paddedHeight, 0);
+    if (data) {
+        for (int row = 0; row < height; ++row) {
+            std::copy(data + static_cast<size_t>(row) * width,
+                      data + static_cast<size_t>(row + 1) * width,
+                      m_uploadScratch.begin() + static_cast<size_t>(row + padding) * paddedWidth + padding);
+        }
+    }
+    GLStateCache::Get().BindTexture(GL_TEXTURE_2D, m_atlasTextures[alloc.page]);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, alloc.x - padding, alloc.y - padding, paddedWidth, paddedHeight,
+                    GL_RED, GL_UNSIGNED_BYTE, m_uploadScratch.data());
+
+    const float inv = 1.0f / static_cast<float>(pageSize);
+    outSlot.page = alloc.page;
+    outSlot.generation = alloc.generation;
+    outSlot.uv = glm::vec4(alloc.x * inv, alloc.y * inv, (alloc.x + width) * inv, (alloc.y + height) * inv);
+    return true;
+}
+
+bool OpenGLFontRenderer::TouchGlyph(const AtlasSlot& slot) {
+    if (!slot.IsValid() || !m_atlas.IsResident(slot.page, slot.generation)) {
+        return false;
+    }
+    m_atlas.Touch(slot.page);
+    return true;
+}
+
+void OpenGLFontRenderer::BeginAtlasPin() {
+    m_atlas.BeginPin();
+}
+
+void OpenGLFontRenderer::EndAtlasPin() {
+    m_atlas.EndPin();
+}
+
+IFontRenderer::TextureId OpenGLFontRenderer::GetAtlasTexture(uint32_t page) const {
+    return page < m_atlasTextures.size() ? static_cast<TextureId>(m_atlasTextures[page]) : 0;
+}
+
 void OpenGLFontRenderer::BindTexture(TextureId id) {
     GLuint tex = static_cast<GLuint>(id);
-    glBindTexture(GL_TEXTURE_2D, tex);
+    GLStateCache::Get().BindTexture(GL_TEXTURE_2D, tex);
 }
 
 void OpenGLFontRenderer::SetProjection(const glm::mat4& projection) {
+    // 投影通常每帧不变，只在变化时更新uniform
+    if (m_projectionSet && projection == m_projection) return;
+    // 已缓存的文字使用旧投影
+    FlushText();
     m_projection = projection;
+    m_projectionSet = true;
     m_shader.use();
     m_shader.setMat4("projection", m_projection);
+    if (m_batchShader) {
+        m_batchShader.use();
+        m_batchShader.setMat4("projection", m_projection);
+    }
 }
 
 void OpenGLFontRenderer::SetTextColor(const glm::vec3& color, float alphaMultiplier) {
     m_textColor = color;
     m_alpha = alphaMultiplier;
+    // 批处理模式下颜色写入顶点，不需要设置uniform
+    if (m_batching) return;
     m_shader.use();
     m_shader.setVec3("textColor", m_textColor);
     m_shader.setFloat("alphaMultiplier", m_alpha);
 }
 
+void OpenGLFontRenderer::SetDistanceField(bool enable) {
+    if (m_distanceField == enable) return;
+    m_distanceField = enable;
+    // 批处理模式下类型写入顶点
+    if (m_batching) return;
+    m_shader.use();
+    m_shader.setInt("distanceField", m_distanceField ? 1 : 0);
+}
+
+void OpenGLFontRenderer::SetBatching(bool enable) {
+    if (m_batching == enable) return;
+    FlushText();
+    m_batching = enable;
+    if (!m_batching) {
+        // 回退路径依赖uniform颜色
+        m_shader.use();
+        m_shader.setVec3("textColor", m_textColor);
+        m_shader.setFloat("alphaMultiplier", m_alpha);
+        m_shader.setInt("distanceField", m_distanceField ? 1 : 0);
+    }
+}
+
 void OpenGLFontRenderer::PrepareForText() {
     if (!m_initialized) return;
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glActiveTexture(GL_TEXTURE0);
+    if (m_batching) {
+        // 成为活动批处理器：其他批处理器的数据先提交，绘制状态在刷新时设置
+        Renderer::Get().SetActiveBatcher(this, &OpenGLFontRenderer::FlushThunk);
+        return;
+    }
+    // 先提交其他批处理器中的图元，保证绘制顺序
+    Renderer::Get().FlushActiveBatcher();
+    GLStateCache::Get().SetBlend(true);
+    GLStateCache::Get().BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLStateCache::Get().ActiveTexture(0);
     m_shader.use();
-    glBindVertexArray(m_vao);
+    GLStateCache::Get().BindVertexArray(m_vao);
 }
 
 void OpenGLFontRenderer::UpdateVertexBuffer(const void* data, size_t size) {
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, m_vbo);
     glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(size), data);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void OpenGLFontRenderer::DrawTriangles(int vertexCount) {
     glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+    m_drawCalls++;
+}
+
+void OpenGLFontRenderer::SubmitQuads(std::span<const GlyphQuad> quads, uint32_t atlasPage) {
+    if (!m_batching) {
+        IFontRenderer::SubmitQuads(quads, atlasPage);
+        return;
+    }
+    if (quads.empty() || atlasPage == AtlasSlot::InvalidPage) return;
+    Renderer::Get().SetActiveBatcher(this, &OpenGLFontRenderer::FlushThunk);
+
+    if (atlasPage >= m_pageVertices.size()) {
+        m_pageVertices.resize(atlasPage + 1);
+    }
+    const unsigned char r = ToByte(m_textColor.r);
+    const unsigned char g = ToByte(m_textColor.g);
+    const unsigned char b = ToByte(m_textColor.b);
+    const unsigned char a = ToByte(m_alpha);
+    const float sdf = m_distanceField ? 1.0f : 0.0f;
+    auto& bucket = m_pageVertices[atlasPage];
+    bucket.reserve(bucket.size() + quads.size() * 6);
+    for (const GlyphQuad& q : quads) {
+        bucket.push_back({ q.x0, q.y1, q.u0, q.v0, r, g, b, a, sdf });
+        bucket.push_back({ q.x0, q.y0, q.u0, q.v1, r, g, b, a, sdf });
+        bucket.push_back({ q.x1, q.y0, q.u1, q.v1, r, g, b, a, sdf });
+
+        bucket.push_back({ q.x0, q.y1, q.u0, q.v0, r, g, b, a, sdf });
+        bucket.push_back({ q.x1, q.y0, q.u1, q.v1, r, g, b, a, sdf });
+        bucket.push_back({ q.x1, q.y1, q.u1, q.v0, r, g, b, a, sdf });
+    }
+    m_pendingVertices += quads.size() * 6;
+}
+
+void OpenGLFontRenderer::FlushText() {
+    Renderer::Get().ReleaseBatcher(this);
+    if (m_pendingVertices == 0 || !m_initialized) return;
+
+    const size_t bytes = m_pendingVertices * sizeof(TextVertex);
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, m_batchVbo);
+    if (bytes > m_batchCapacity) {
+        m_batchCapacity = std::max(bytes, m_batchCapacity * 2);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_batchCapacity), nullptr, GL_STREAM_DRAW);
+    }
+    // 整体作废旧内容后映射，驱动无需等待上一批绘制完成
+    auto* dst = static_cast<TextVertex*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(bytes),
+                                                         GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+    m_pageRanges.clear();
+    if (dst) {
+        int first = 0;
+        for (uint32_t page = 0; page < m_pageVertices.size(); ++page) {
+            auto& bucket = m_pageVertices[page];
+            if (bucket.empty()) continue;
+            std::copy(bucket.begin(), bucket.end(), dst + first);
+            m_pageRanges.push_back({ page, first, static_cast<int>(bucket.size()) });
+            first += static_cast<int>(bucket.size());
+        }
+        if (!glUnmapBuffer(GL_ARRAY_BUFFER)) {
+            // 映射内容丢失（例如显示模式切换），本批放弃
+            m_pageRanges.clear();
+        }
+    } else {
+        std::cerr << "Failed to map text vertex buffer" << std::endl;
+    }
+
+    if (!m_pageRanges.empty()) {
+        GLStateCache::Get().SetBlend(true);
+        GLStateCache::Get().BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        GLStateCache::Get().ActiveTexture(0);
+        m_batchShader.use();
+        GLStateCache::Get().BindVertexArray(m_batchVao);
+        for (const PageRange& range : m_pageRanges) {
+            GLStateCache::Get().BindTexture(GL_TEXTURE_2D, static_cast<GLuint>(GetAtlasTexture(range.page)));
+            glDrawArrays(GL_TRIANGLES, range.first, range.count);
+        }
+        m_drawCalls += static_cast<unsigned int>(m_pageRanges.size());
+    }
+
+    for (auto& bucket : m_pageVertices) {
+        bucket.clear();
+    }
+    m_pendingVertices = 0;
+}
+
+unsigned int OpenGLFontRenderer::TakeDrawCalls() {
+    const unsigned int count = m_drawCalls;
+    m_drawCalls = 0;
+    return count;
 }
 
 void OpenGLFontRenderer::Shutdown() {
-    if (m_vao) { glDeleteVertexArrays(1, &m_vao); m_vao = 0; }
-    if (m_vbo) { glDeleteBuffers(1, &m_vbo); m_vbo = 0; }
+    for (auto& bucket : m_pageVertices) {
+        bucket.clear();
+    }
+    m_pendingVertices = 0;
+    GLStateCache& state = GLStateCache::Get();
+    if (m_vao) { glDeleteVertexArrays(1, &m_vao); state.OnVertexArrayDeleted(m_vao); m_vao = 0; }
+    if (m_vbo) { glDeleteBuffers(1, &m_vbo); state.OnBufferDeleted(m_vbo); m_vbo = 0; }
+    if (m_batchVao) { glDeleteVertexArrays(1, &m_batchVao); state.OnVertexArrayDeleted(m_batchVao); m_batchVao = 0; }
+    if (m_batchVbo) { glDeleteBuffers(1, &m_batchVbo); state.OnBufferDeleted(m_batchVbo); m_batchVbo = 0; }
+    m_batchCapacity = 0;
+    for (auto& tex : m_atlasTextures) {
+        if (tex) { glDeleteTextures(1, &tex); state.OnTextureDeleted(tex); tex = 0; }
+    }
+    m_atlasTextures.clear();
+    m_atlas.Clear();
     // 不删除 shader（若需要，可增加 cleanup）
     m_initialized = false;
 }
@@ -0,0 +1,292 @@
+#include <glad/glad.h>
+#include "core/render/Profiler.h"
+#include "core/render/Drawer.h"
+#include "core/render/GLBase.h"
+#include "core/render/Renderer.h"
+#include "core/baseItem/Font.h"
+#include "core/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using namespace core;
+
+namespace {
+constexpr uint32_t kNoZone = 0xFFFFFFFFu;
+// 同时等待回读的计时查询上限（驱动长时间不返回结果时停止发出新查询）
+constexpr size_t kMaxPendingQueries = 256;
+
+void WriteJsonString(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* p = text; *p; ++p) {
+        const char c = *p;
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << ' ';
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+}
+
+Profiler& Profiler::Get() {
+    // 不在程序结束时析构：计时查询属于GL上下文，退出时上下文可能已经销毁
+    static Profiler* instance = new Profiler;
+    return *instance;
+}
+
+Profiler::Profiler() : m_epoch(Clock::now()) {
+    m_stack.reserve(32);
+}
+
+int64_t Profiler::NowUs() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - m_epoch).count();
+}
+
+const Profiler::Frame* Profiler::FindFrame(uint64_t frameIndex) const {
+    const Frame& frame = m_frames[frameIndex % FrameHistory];
+    return frame.index == frameIndex ? &frame : nullptr;
+}
+
+void Profiler::DetectGpuTiming() {
+    m_gpuChecked = true;
+    // 空后端没有真正的查询结果
+    m_gpuAvailable = Renderer::Get().GetBackend() == Renderer::Backend::OpenGL
+        && (GLAD_GL_VERSION_3_3 || GLAD_GL_ARB_timer_query);
+    Log << Level::Info << "Profiler GPU timing " << (m_gpuAvailable ? "available" : "unavailable") << op::endl;
+}
+
+void Profiler::CollectQueries() {
+    // 查询按发出顺序完成，遇到第一个未完成的即可停止
+    size_t done = 0;
+    for (; done < m_pendingQueries.size(); ++done) {
+        const PendingQuery& pending = m_pendingQueries[done];
+        GLint available = 0;
+        GLCall(glGetQueryObjectiv(pending.query, GL_QUERY_RESULT_AVAILABLE, &available));
+        if (!available) break;
+        GLuint64 elapsed = 0;
+        GLCall(glGetQueryObjectui64v(pending.query, GL_QUERY_RESULT, &elapsed));
+        Frame& frame = Slot(pending.frameIndex);
+        // 帧已被环形缓冲区覆盖时丢弃结果
+        if (frame.index == pending.frameIndex && pending.zone < frame.zones.size()) {
+            frame.zones[pending.zone].gpuNs = static_cast<int64_t>(elapsed);
+        }
+        m_freeQueries.push_back(pending.query);
+    }
+    m_pendingQueries.erase(m_pendingQueries.begin(), m_pendingQueries.begin() + done);
+}
+
+void Profiler::BeginFrame() {
+    if (!m_enabled) return;
+    if (!m_gpuChecked) DetectGpuTiming();
+    if (!m_pendingQueries.empty()) CollectQueries();
+
+    Frame& frame = Slot(++m_frameIndex);
+    frame.index = m_frameIndex;
+    frame.startUs = NowUs();
+    frame.durUs = 0;
+    frame.zones.clear();
+    m_stack.clear();
+    m_inFrame = true;
+}
+
+void Profiler::EndFrame() {
+    if (!m_inFrame) return;
+    // 未结束的区域（异常跳出等）截断到帧结束
+    while (!m_stack.empty()) EndZone();
+    Frame& frame = Slot(m_frameIndex);
+    frame.durUs = NowUs() - frame.startUs;
+    m_inFrame = false;
+}
+
+void Profiler::BeginZone(const char* name) {
+    Frame& frame = Slot(m_frameIndex);
+    if (!m_inFrame || frame.zones.size() >= MaxZonesPerFrame) {
+        m_stack.push_back(kNoZone);
+        m_dropped++;
+        return;
+    }
+    const uint32_t index = static_cast<uint32_t>(frame.zones.size());
+    const uint32_t depth = static_cast<uint32_t>(m_stack.size());
+    frame.zones.push_back({ name, NowUs(), 0, -1, depth });
+    m_stack.push_back(index);
+
+    // GL_TIME_ELAPSED 查询不能嵌套，只给最外层的区域计时
+    if (m_gpuRequested && m_gpuAvailable && m_gpuZoneDepth < 0 && m_pendingQueries.size() < kMaxPendingQueries) {
+        unsigned int query = 0;
+        if (m_freeQueries.empty()) {
+            GLCall(glGenQueries(1, &query));
+        } else {
+            query = m_freeQueries.back();
+            m_freeQueries.pop_back();
+        }
+        GLCall(glBeginQuery(GL_TIME_ELAPSED, query));
+        m_pendingQueries.push_back({ query, m_frameIndex, index });
+        m_gpuZoneDepth = static_cast<int>(depth);
+    }
+}
+
+void Profiler::EndZone() {
+    if (m_stack.empty()) return;
+    const uint32_t index = m_stack.back();
+    m_stack.pop_back();
+    if (index == kNoZone) return;
+
+    Zone& zone = Slot(m_frameIndex).zones[index];
+    zone.durUs = NowUs() - zone.startUs;
+    if (m_gpuZoneDepth == static_cast<int>(zone.depth)) {
+        GLCall(glEndQuery(GL_TIME_ELAPSED));
+        m_gpuZoneDepth = -1;
+    }
+}
+
+double Profiler::GetFrameTimePercentile(double p) const {
+    std::vector<int64_t> durations;
+    durations.reserve(FrameHistory);
+    for (const Frame& frame : m_frames) {
+        if (frame.index == 0 || frame.durUs <= 0) continue;
+        durations.push_back(frame.durUs);
+    }
+    if (durations.empty()) return 0.0;
+    // 最近秩法
+    p = std::clamp(p, 0.0, 100.0);
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * durations.size()));
+    rank = std::clamp<size_t>(rank, 1, durations.size()) - 1;
+    std::nth_element(durations.begin(), durations.begin() + rank, durations.end());
+    return durations[rank] / 1000.0;
+}
+
+std::vector<ProfileZoneSummary> Profiler::GetTopZones(size_t count) const {
+    struct Accum {
+        const char* name;
+        int64_t cpuUs = 0;
+        int64_t gpuNs = 0;
+        uint64_t calls = 0;
+        uint64_t gpuFrames = 0;
+        uint64_t lastGpuFrame = 0;
+    };
+    std::vector<Accum> zones;
+    size_t frames = 0;
+    for (const Frame& frame : m_frames) {
+        if (frame.index == 0 || frame.durUs <= 0) continue;
+        frames++;
+        for (const Zone& zone : frame.zones) {
+            // 名字是静态字符串，但不同编译单元中相同的字面量不一定共享地址
+            auto it = std::find_if(zones.begin(), zones.end(), [&](const Accum& a) {
+                return a.name == zone.name || std::strcmp(a.name, zone.name) == 0;
+            });
+            if (it == zones.end()) {
+                zones.push_back({ zone.name });
+                it = zones.end() - 1;
+            }
+            it->cpuUs += zone.durUs;
+            it->calls++;
+            if (zone.gpuNs >= 0) {
+                it->gpuNs += zone.gpuNs;
+                if (it->lastGpuFrame != frame.index) {
+                    it->lastGpuFrame = frame.index;
+                    it->gpuFrames++;
+                }
+            }
+        }
+    }
+
+    std::vector<ProfileZoneSummary> result;
+    if (frames == 0) return result;
+    result.reserve(zones.size());
+    for (const Accum& a : zones) {
+        ProfileZoneSummary summary;
+        summary.name = a.name;
+        summary.cpuMs = a.cpuUs / 1000.0 / frames;
+        summary.gpuMs = a.gpuFrames ? a.gpuNs / 1.0e6 / a.gpuFrames : -1.0;
+        summary.callsPerFrame = static_cast<double>(a.calls) / frames;
+        result.push_back(summary);
+    }
+    std::sort(result.begin(), result.end(), [](const ProfileZoneSummary& a, const ProfileZoneSummary& b) {
+        return a.cpuMs > b.cpuMs;
+    });
+    if (result.size() > count) result.resize(count);
+    return result;
+}
+
+void Profiler::DrawOverlay(Font& font) {
+    PROFILE_SCOPE("profiler overlay");
+    const std::vector<ProfileZoneSummary> zones = GetTopZones(8);
+
+    std::vector<std::string> lines;
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2) << "Frame p50 " << GetFrameTimePercentile(50)
+       << " ms  p95 " << GetFrameTimePercentile(95) << " ms  p99 " << GetFrameTimePercentile(99) << " ms";
+    lines.push_back(ss.str());
+    for (const ProfileZoneSummary& zone : zones) {
+        ss.str("");
+        ss << zone.name << "  cpu " << zone.cpuMs << " ms";
+        if (zone.gpuMs >= 0.0) ss << "  gpu " << zone.gpuMs << " ms";
+        ss << "  x" << std::setprecision(1) << zone.callsPerFrame << std::setprecision(2);
+        lines.push_back(ss.str());
+    }
+
+    // 右上角面板，行高随窗口高度缩放（与字体的动态缩放一致）
+    const float lineHeight = WindowInfo.height / 28.0f;
+    const float x = WindowInfo.width * 0.5f;
+    const float padding = lineHeight * 0.25f;
+    Drawer::getInstance()->DrawSquare(
+        Region(x - padding, 0, WindowInfo.width, lineHeight * lines.size() + padding * 2, false),
+        Color(255, 255, 255, 200), true);
+    for (size_t i = 0; i < lines.size(); ++i) {
+        font.RenderText(lines[i], x, padding + lineHeight * i, 0.35f, color::black);
+    }
+}
+
+bool Profiler::ExportChromeTrace(const std::string& path) const {
+    std::error_code ec;
+    const std::filesystem::path file(path);
+    if (file.has_parent_path()) {
+        std::filesystem::create_directories(file.parent_path(), ec);
+    }
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        Log << Level::Error << "Profiler: cannot write trace " << path << op::endl;
+        return false;
+    }
+
+    // 按帧序号输出，跳过空槽与未结束的帧
+    std::vector<const Frame*> frames;
+    for (const Frame& frame : m_frames) {
+        if (frame.index != 0 && frame.durUs > 0) frames.push_back(&frame);
+    }
+    std::sort(frames.begin(), frames.end(), [](const Frame* a, const Frame* b) { return a->index < b->index; });
+
+    // 完整事件（ph "X"），ts/dur 单位为微秒；GPU耗时没有对应的时间戳，作为参数附在区域上
+    out << "{\"traceEvents\":[\n";
+    out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"main\"}}";
+    for (const Frame* frame : frames) {
+        out << ",\n{\"name\":\"frame\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << frame->startUs
+            << ",\"dur\":" << frame->durUs << ",\"args\":{\"index\":" << frame->index << "}}";
+        for (const Zone& zone : frame->zones) {
+            out << ",\n{\"name\":";
+            WriteJsonString(out, zone.name);
+            out << ",\"cat\":\"zone\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << zone.startUs
+                << ",\"dur\":" << zone.durUs;
+            if (zone.gpuNs >= 0) {
+                out << ",\"args\":{\"gpu_us\":" << zone.gpuNs / 1000.0 << "}";
+            }
+            out << "}";
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    if (!out) {
+        Log << Level::Error << "Profiler: failed writing trace " << path << op::endl;
+        return false;
+    }
+    Log << Level::Info << "Profiler: exported " << frames.size() << " frames to " << path << op::endl;
+    return true;
+}
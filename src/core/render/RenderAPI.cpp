@@ -1,6 +1,7 @@
 #include <glad/glad.h>
 #include "core/render/RenderAPI.h"
 #include "core/render/GLBase.h"
+#include "core/render/GLStateCache.h"
 
 namespace core {
 
@@ -20,7 +21,7 @@ void RenderAPI::SwapBuffers(GLFWwindow* window) {
 }
 
 void RenderAPI::Viewport(int x, int y, int width, int height) {
-    GLCall(glViewport(x, y, width, height));
+    GLStateCache::Get().Viewport(x, y, width, height);
 }
 
 void RenderAPI::ClearColor(float r, float g, float b, float a) {
@@ -31,4 +32,13 @@ void RenderAPI::Clear(unsigned int mask) {
     GLCall(glClear(mask));
 }
 
+void RenderAPI::SetScissor(int x, int y, int width, int height) {
+    GLCall(glEnable(GL_SCISSOR_TEST));
+    GLCall(glScissor(x, y, width, height));
+}
+
+void RenderAPI::DisableScissor() {
+    GLCall(glDisable(GL_SCISSOR_TEST));
+}
+
 } // namespace core
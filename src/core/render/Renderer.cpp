@@ -23,4 +23,25 @@ void Renderer::CallWithError(const std::function<void()>& fn, const char* exprSt
     }
 }
 
+void Renderer::SetActiveBatcher(void* owner, BatchFlushFn flush) {
+    if (m_activeBatcher == owner) return;
+    // 先清除活动状态再刷新，避免刷新过程中重入
+    void* previous = m_activeBatcher;
+    BatchFlushFn previousFlush = m_activeFlush;
+    m_activeBatcher = nullptr;
+    m_activeFlush = nullptr;
+    if (previous && previousFlush) {
+        previousFlush(previous);
+    }
+    m_activeBatcher = owner;
+    m_activeFlush = flush;
+}
+
+void Renderer::ReleaseBatcher(void* owner) {
+    if (m_activeBatcher == owner) {
+        m_activeBatcher = nullptr;
+        m_activeFlush = nullptr;
+    }
+}
+
 } // namespace core
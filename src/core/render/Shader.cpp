@@ -1,124 +1,114 @@
 #include"core/render/Shader.h"
 #include "core/render/GLBase.h"
+#include "core/render/GLStateCache.h"
+#include "core/render/ShaderProgramCache.h"
 #include "core/log.h"
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
 
 using namespace core;
 
-
-static unsigned int compileShader(unsigned int type, const std::string& source) {
-    Log<<Level::Info<<"compileShader() "<<source<<op::endl;
-    unsigned int id;
-    GLCall(id = glCreateShader(type));
-    const char* src = source.c_str();
-    GLCall(glShaderSource(id, 1, &src, nullptr));
-    GLCall(glCompileShader(id));
-
-    // 检查编译错误
-    int result;
-    GLCall(glGetShaderiv(id, GL_COMPILE_STATUS, &result));
-    if (result == GL_FALSE) {
-        int length;
-        GLCall(glGetShaderiv(id, GL_INFO_LOG_LENGTH, &length));
-        char* message = new char[length];
-        GLCall(glGetShaderInfoLog(id, length, &length, message));
-        Log<<Level::Error<<"Failed to compile shader!"<<op::endl;
-        Log<<Level::Error<<message<<op::endl;
-        delete[] message;
-        GLCall(glDeleteShader(id));
-        return 0;
-    }
-    return id;
-}
+UniformStats Shader::stats;
 
 Shader::Shader(const std::string& VertexShader, const std::string& fragmentShader) {
     init(VertexShader, fragmentShader);
 }
 
-Shader::Shader(const Shader& shader) {
-    Log<<Level::Info<<"Shader::Shader(const Shader&) "<<shader.ID<<"to"<<ID<<op::endl;
-    if(this != &shader) {
-        if(ID != 0) {
-            GLCall(glDeleteProgram(ID));
-        }
-        init(shader.VertexShader, shader.fragmentShader);
-    }
+Shader::Shader(const Shader& shader) : ID(shader.ID), program(shader.program) {
+    // 共享同一个已链接程序，只增加引用计数
+    ShaderProgramCache::Get().AddRef(program);
 }
 
 Shader::Shader() : ID(0) {}
 
 Shader::~Shader() {
-    Log<<Level::Info<<"Shader::~Shader() "<<ID<<op::endl;
-    
-    // 只有在ID有效时才删除程序
-    if (ID != 0) {
-        try {
-            GLCall(glDeleteProgram(ID));
-            Log<<Level::Info<<"Shader program "<<ID<<" deleted successfully"<<op::endl;
-        } catch (const std::exception& e) {
-            Log<<Level::Error<<"Exception occurred while deleting shader program "<<ID<<": "<<e.what()<<op::endl;
-        } catch (...) {
-            Log<<Level::Error<<"Unknown exception occurred while deleting shader program "<<ID<<op::endl;
-        }
-    } else {
-        Log<<Level::Warn<<"OpenGL context invalid, skipping shader program "<<ID<<" deletion"<<op::endl;
+    Release();
+}
+
+void Shader::Release() {
+    if (program) {
+        ShaderProgramCache::Get().Release(program);
     }
+    program = nullptr;
     ID = 0;
-    
-    Log<<Level::Info<<"Shader::~Shader() finished ID "<<ID<<op::endl;
 }
 
 void Shader::init(const std::string& VertexShader, const std::string& fragmentShader) {
-    Log<<Level::Info<<"Shader::init() "<<op::endl;
-    
-    if (ID != 0) {
-        GLCall(glDeleteProgram(ID));
-    }
-    this->VertexShader = VertexShader;
-    this->fragmentShader = fragmentShader;
-
-    unsigned int program;
-    GLCall(program = glCreateProgram());
-    unsigned int vs = compileShader(GL_VERTEX_SHADER, VertexShader);
-    Log<<Level::Info<<"Shader::init() vs "<<vs<<op::endl;
-    if (vs == 0) {
-        Log<<Level::Error<<"Shader::init() vs compile error "<<op::endl;
+    Release();
+    program = ShaderProgramCache::Get().Acquire(VertexShader, fragmentShader);
+    if (!program) {
+        Log<<Level::Error<<"Shader::init() failed to build program"<<op::endl;
         return;
     }
-    unsigned int fs = compileShader(GL_FRAGMENT_SHADER, fragmentShader);
-    Log<<Level::Info<<"Shader::init() fs "<<fs<<op::endl;
-    if (fs == 0) {
-        Log<<Level::Error<<"Shader::init() fs compile error "<<op::endl;
-        GLCall(glDeleteShader(vs));
-        return;
+    ID = program->id;
+}
+
+UniformHandle Shader::GetUniform(std::string_view name) const {
+    UniformHandle handle;
+    if (!program) return handle;
+    const std::vector<ShaderUniform>& uniforms = program->uniforms;
+    // uniform数量很少，线性查找比哈希更快
+    for (size_t i = 0; i < uniforms.size(); ++i) {
+        if (uniforms[i].name == name) {
+            handle.index = static_cast<int>(i);
+            break;
+        }
     }
+    stats.lookupsAvoided++;
+    return handle;
+}
 
-    GLCall(glAttachShader(program, vs));
-    GLCall(glAttachShader(program, fs));
-    GLCall(glLinkProgram(program));
-    GLCall(glValidateProgram(program));
-
-    GLCall(glDeleteShader(vs));
-    GLCall(glDeleteShader(fs));
-    Log<<Level::Info<<"Shader::init() program "<<program<<op::endl;
-    // 检查链接错误
-    int linkResult;
-    GLCall(glGetProgramiv(program, GL_LINK_STATUS, &linkResult));
-    if (linkResult == GL_FALSE) {
-        int length;
-        GLCall(glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length));
-        char* message = new char[length];
-        GLCall(glGetProgramInfoLog(program, length, &length, message));
-        Log<<Level::Error<<"Shader::init() Failed to link program!"<<op::endl;
-        Log<<Level::Error<<message<<op::endl;
-        delete[] message;
-        GLCall(glDeleteProgram(program));
-        return;
+int Shader::Location(std::string_view name) const {
+    UniformHandle handle = GetUniform(name);
+    return handle ? program->uniforms[handle.index].location : -1;
+}
+
+bool Shader::UpdateValue(UniformHandle handle, const void* data, size_t bytes) const {
+    // 值缓存随程序共享：共享同一程序的 Shader 副本看到一致的uniform状态
+    ShaderUniform& slot = program->uniforms[handle.index];
+    if (slot.hasValue && std::memcmp(slot.value, data, bytes) == 0) {
+        stats.callsElided++;
+        return false;
     }
-    ID = program;
+    std::memcpy(slot.value, data, bytes);
+    slot.hasValue = true;
+    stats.callsIssued++;
+    return true;
+}
+
+void Shader::setInt(UniformHandle handle, int value) const {
+    if (!handle || !UpdateValue(handle, &value, sizeof(value))) return;
+    GLCall(glUniform1i(program->uniforms[handle.index].location, value));
+}
+
+void Shader::setFloat(UniformHandle handle, float value) const {
+    if (!handle || !UpdateValue(handle, &value, sizeof(value))) return;
+    GLCall(glUniform1f(program->uniforms[handle.index].location, value));
+}
+
+void Shader::set2float(UniformHandle handle, float value1, float value2) const {
+    const float value[2] = { value1, value2 };
+    if (!handle || !UpdateValue(handle, value, sizeof(value))) return;
+    GLCall(glUniform2f(program->uniforms[handle.index].location, value1, value2));
+}
+
+void Shader::setVec3(UniformHandle handle, const glm::vec3& value) const {
+    if (!handle || !UpdateValue(handle, &value[0], sizeof(float) * 3)) return;
+    GLCall(glUniform3f(program->uniforms[handle.index].location, value.x, value.y, value.z));
+}
+
+void Shader::setVec4(UniformHandle handle, const glm::vec4& value) const {
+    if (!handle || !UpdateValue(handle, &value[0], sizeof(float) * 4)) return;
+    GLCall(glUniform4f(program->uniforms[handle.index].location, value.x, value.y, value.z, value.w));
+}
+
+void Shader::setMat4(UniformHandle handle, const glm::mat4& mat) const {
+    if (!handle || !UpdateValue(handle, &mat[0][0], sizeof(float) * 16)) return;
+    GLCall(glUniformMatrix4fv(program->uniforms[handle.index].location, 1, GL_FALSE, &mat[0][0]));
 }
 
 void Shader::use() const {
@@ -127,16 +117,15 @@ void Shader::use() const {
         return;
     }
     
-    GLCall(glUseProgram(ID));
+    GLStateCache::Get().UseProgram(ID);
 }
 
 Shader& Shader::operator=(const Shader& shader) {
-    Log<<Level::Info<<"Shader::operator=() "<<shader.ID<<" to "<<ID<<op::endl;
     if (this != &shader) {
-        if (ID != 0) {
-            GLCall(glDeleteProgram(ID));
-        }
-        init(shader.VertexShader, shader.fragmentShader);
+        ShaderProgramCache::Get().AddRef(shader.program);
+        Release();
+        program = shader.program;
+        ID = shader.ID;
     }
     return *this;
-}
\ No newline at end of file
+}
@@ -0,0 +1,287 @@
+#include <glad/glad.h>
+#include "core/render/ShaderProgramCache.h"
+#include "core/render/GLBase.h"
+#include "core/render/GLStateCache.h"
+#include "core/log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using namespace core;
+
+namespace {
+constexpr char kMagic[4] = { 'P', 'W', 'S', 'P' };
+constexpr uint32_t kVersion = 1;
+
+// FNV-1a 64 位，可分段累加
+uint64_t Hash(const std::string& data, uint64_t hash = 1469598103934665603ull) {
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    // 分隔符，避免 ("ab","c") 与 ("a","bc") 相同
+    hash ^= 0xFF;
+    hash *= 1099511628211ull;
+    return hash;
+}
+
+unsigned int compileShader(unsigned int type, const std::string& source) {
+    unsigned int id;
+    GLCall(id = glCreateShader(type));
+    const char* src = source.c_str();
+    GLCall(glShaderSource(id, 1, &src, nullptr));
+    GLCall(glCompileShader(id));
+
+    // 检查编译错误，只有失败时才输出源码
+    int result;
+    GLCall(glGetShaderiv(id, GL_COMPILE_STATUS, &result));
+    if (result == GL_FALSE) {
+        int length;
+        GLCall(glGetShaderiv(id, GL_INFO_LOG_LENGTH, &length));
+        std::vector<char> message(static_cast<size_t>(std::max(length, 1)));
+        GLCall(glGetShaderInfoLog(id, length, &length, message.data()));
+        Log<<Level::Error<<"Failed to compile shader!"<<op::endl;
+        Log<<Level::Error<<message.data()<<op::endl;
+        Log<<Level::Error<<source<<op::endl;
+        GLCall(glDeleteShader(id));
+        return 0;
+    }
+    return id;
+}
+
+bool LinkSucceeded(unsigned int program) {
+    int linkResult;
+    GLCall(glGetProgramiv(program, GL_LINK_STATUS, &linkResult));
+    return linkResult != GL_FALSE;
+}
+}
+
+ShaderProgramCache& ShaderProgramCache::Get() {
+    // 不在程序结束时析构：静态的 Shader 对象可能比缓存更晚释放
+    static ShaderProgramCache* instance = new ShaderProgramCache;
+    return *instance;
+}
+
+void ShaderProgramCache::InitBinarySupport() {
+    binaryChecked = true;
+    if (!GLAD_GL_VERSION_4_1 && !GLAD_GL_ARB_get_program_binary) {
+        return;
+    }
+    int formats = 0;
+    GLCall(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats));
+    if (formats <= 0) {
+        Log<<Level::Info<<"ShaderProgramCache: driver exposes no program binary formats"<<op::endl;
+        return;
+    }
+    // 驱动更新后旧的二进制不再可用，因此驱动字符串参与哈希
+    for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+        const GLubyte* value = glGetString(name);
+        if (value) driver += reinterpret_cast<const char*>(value);
+        driver += '\n';
+    }
+    binarySupported = true;
+}
+
+std::string ShaderProgramCache::BinaryPath(uint64_t hash) const {
+    std::ostringstream name;
+    name << CacheDirectory << "/" << std::hex << std::setw(16) << std::setfill('0') << hash << ".bin";
+    return name.str();
+}
+
+unsigned int ShaderProgramCache::LoadBinary(uint64_t hash) {
+    const std::string path = BinaryPath(hash);
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return 0;
+
+    FileHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion
+        || header.sourceHash != hash || header.length == 0) {
+        Log<<Level::Warn<<"ShaderProgramCache: ignoring stale or corrupt cache "<<path<<op::endl;
+        return 0;
+    }
+    std::vector<char> binary(header.length);
+    in.read(binary.data(), static_cast<std::streamsize>(binary.size()));
+    if (!in) return 0;
+
+    unsigned int program;
+    GLCall(program = glCreateProgram());
+    GLCall(glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size())));
+    if (!LinkSucceeded(program)) {
+        // 驱动拒绝（例如格式变化），删除后回退到从源码编译
+        GLCall(glDeleteProgram(program));
+        in.close();
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        return 0;
+    }
+    return program;
+}
+
+void ShaderProgramCache::SaveBinary(unsigned int program, uint64_t hash) {
+    int length = 0;
+    GLCall(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length));
+    if (length <= 0) return;
+    std::vector<char> binary(static_cast<size_t>(length));
+    GLenum format = 0;
+    GLCall(glGetProgramBinary(program, length, &length, &format, binary.data()));
+    if (length <= 0) return;
+
+    FileHeader header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.sourceHash = hash;
+    header.format = format;
+    header.length = static_cast<uint32_t>(length);
+
+    std::error_code ec;
+    std::filesystem::create_directories(CacheDirectory, ec);
+    const std::string path = BinaryPath(hash);
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            Log<<Level::Warn<<"ShaderProgramCache: cannot write "<<tempPath<<op::endl;
+            return;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(binary.data(), length);
+        if (!out) {
+            out.close();
+            std::filesystem::remove(tempPath, ec);
+            return;
+        }
+    }
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        Log<<Level::Warn<<"ShaderProgramCache: cannot replace "<<path<<": "<<ec.message()<<op::endl;
+        std::filesystem::remove(tempPath, ec);
+    }
+}
+
+unsigned int ShaderProgramCache::CompileAndLink(const std::string& vertexSource, const std::string& fragmentSource) {
+    unsigned int vs = compileShader(GL_VERTEX_SHADER, vertexSource);
+    if (vs == 0) {
+        Log<<Level::Error<<"ShaderProgramCache: vertex shader compile error"<<op::endl;
+        return 0;
+    }
+    unsigned int fs = compileShader(GL_FRAGMENT_SHADER, fragmentSource);
+    if (fs == 0) {
+        Log<<Level::Error<<"ShaderProgramCache: fragment shader compile error"<<op::endl;
+        GLCall(glDeleteShader(vs));
+        return 0;
+    }
+
+    unsigned int program;
+    GLCall(program = glCreateProgram());
+    GLCall(glAttachShader(program, vs));
+    GLCall(glAttachShader(program, fs));
+    if (binarySupported) {
+        GLCall(glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+    }
+    GLCall(glLinkProgram(program));
+#ifdef DEBUG_MODE
+    // 校验结果取决于当前绑定状态，只在调试构建中作为参考
+    GLCall(glValidateProgram(program));
+#endif
+    GLCall(glDetachShader(program, vs));
+    GLCall(glDetachShader(program, fs));
+    GLCall(glDeleteShader(vs));
+    GLCall(glDeleteShader(fs));
+
+    if (!LinkSucceeded(program)) {
+        int length;
+        GLCall(glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length));
+        std::vector<char> message(static_cast<size_t>(std::max(length, 1)));
+        GLCall(glGetProgramInfoLog(program, length, &length, message.data()));
+        Log<<Level::Error<<"ShaderProgramCache: Failed to link program!"<<op::endl;
+        Log<<Level::Error<<message.data()<<op::endl;
+        GLCall(glDeleteProgram(program));
+        return 0;
+    }
+    return program;
+}
+
+void ShaderProgramCache::LoadUniforms(ShaderProgram& program) {
+    // 链接后一次性解析所有活动uniform的位置
+    program.uniforms.clear();
+    int count = 0, maxLength = 0;
+    GLCall(glGetProgramiv(program.id, GL_ACTIVE_UNIFORMS, &count));
+    GLCall(glGetProgramiv(program.id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength));
+    std::vector<char> name(static_cast<size_t>(std::max(maxLength, 1)));
+    program.uniforms.reserve(static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i) {
+        int length = 0, size = 0;
+        GLenum type = 0;
+        GLCall(glGetActiveUniform(program.id, static_cast<GLuint>(i), maxLength, &length, &size, &type, name.data()));
+        ShaderUniform slot;
+        slot.name.assign(name.data(), static_cast<size_t>(length));
+        // 数组uniform以 "name[0]" 形式返回，按 "name" 查找
+        if (slot.name.size() > 3 && slot.name.compare(slot.name.size() - 3, 3, "[0]") == 0) {
+            slot.name.resize(slot.name.size() - 3);
+        }
+        GLCall(slot.location = glGetUniformLocation(program.id, slot.name.c_str()));
+        // 内置uniform（gl_前缀）没有位置
+        if (slot.location < 0) continue;
+        program.uniforms.push_back(std::move(slot));
+    }
+}
+
+ShaderProgram* ShaderProgramCache::Acquire(const std::string& vertexSource, const std::string& fragmentSource) {
+    std::string key;
+    key.reserve(vertexSource.size() + fragmentSource.size() + 1);
+    key.append(vertexSource).push_back('\0');
+    key.append(fragmentSource);
+
+    auto it = programs.find(key);
+    if (it != programs.end()) {
+        it->second->refs++;
+        return it->second.get();
+    }
+
+    if (!binaryChecked) InitBinarySupport();
+    uint64_t hash = 0;
+    unsigned int id = 0;
+    if (binarySupported) {
+        hash = Hash(fragmentSource, Hash(vertexSource, Hash(driver)));
+        id = LoadBinary(hash);
+        if (id != 0) {
+            Log<<Level::Info<<"ShaderProgramCache: loaded program "<<id<<" from binary cache"<<op::endl;
+        }
+    }
+    if (id == 0) {
+        id = CompileAndLink(vertexSource, fragmentSource);
+        if (id == 0) return nullptr;
+        if (binarySupported) SaveBinary(id, hash);
+        Log<<Level::Info<<"ShaderProgramCache: compiled program "<<id<<op::endl;
+    }
+
+    auto program = std::make_unique<ShaderProgram>();
+    program->id = id;
+    program->refs = 1;
+    program->key = key;
+    LoadUniforms(*program);
+    ShaderProgram* result = program.get();
+    programs.emplace(std::move(key), std::move(program));
+    return result;
+}
+
+void ShaderProgramCache::AddRef(ShaderProgram* program) {
+    if (program) program->refs++;
+}
+
+void ShaderProgramCache::Release(ShaderProgram* program) {
+    if (!program || program->refs == 0) return;
+    if (--program->refs > 0) return;
+
+    const unsigned int id = program->id;
+    GLCall(glDeleteProgram(id));
+    GLStateCache::Get().OnProgramDeleted(id);
+    // key 属于即将删除的条目，先复制
+    const std::string key = program->key;
+    programs.erase(key);
+}
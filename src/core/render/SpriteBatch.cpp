@@ -0,0 +1,169 @@
+#include "core/render/SpriteBatch.h"
+#include "core/render/GLBase.h"
+#include "core/render/GLStateCache.h"
+#include "core/render/Renderer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+using namespace core;
+
+namespace {
+// 与 Texture 默认顶点一致：左上、右上、右下、左下
+constexpr float kCorners[4][4] = {
+    // 位置          // 纹理坐标
+    { -0.5f,  0.5f,  0.0f, 1.0f },
+    {  0.5f,  0.5f,  1.0f, 1.0f },
+    {  0.5f, -0.5f,  1.0f, 0.0f },
+    { -0.5f, -0.5f,  0.0f, 0.0f },
+};
+// 两个三角形，对应 Texture 的索引 {0,1,2, 2,3,0}
+constexpr int kQuadOrder[6] = { 0, 1, 2, 2, 3, 0 };
+}
+
+SpriteBatch& SpriteBatch::Get() {
+    static SpriteBatch instance;
+    return instance;
+}
+
+void SpriteBatch::InitResources() {
+    static const char* vertexShaderSource = R"(
+    #version 330 core
+    layout(location = 0) in vec2 aPos;
+    layout(location = 1) in vec2 aTexCoord;
+    layout(location = 2) in float aAlpha;
+    out vec2 TexCoord;
+    out float Alpha;
+
+    void main()
+    {
+        gl_Position = vec4(aPos, 0.0, 1.0);
+        TexCoord = aTexCoord;
+        Alpha = aAlpha;
+    }
+    )";
+
+    static const char* fragmentShaderSource = R"(
+    #version 330 core
+    in vec2 TexCoord;
+    in float Alpha;
+    out vec4 FragColor;
+    uniform sampler2D texture1;
+
+    void main()
+    {
+        vec4 texColor = texture(texture1, TexCoord);
+        FragColor = vec4(texColor.rgb, texColor.a * Alpha);
+    }
+    )";
+
+    m_shader.init(vertexShaderSource, fragmentShaderSource);
+    m_shader.use();
+    m_shader.setInt("texture1", 0);
+
+    // 与 Texture 的共享顶点数组一样在程序结束时不释放（上下文可能已销毁）
+    m_va = new VertexArray;
+    m_vb = new VertexBuffer;
+    m_va->AddBuffer(*m_vb, 0, 2, GL_FLOAT, false, sizeof(SpriteVertex), (const void*)offsetof(SpriteVertex, x));
+    m_va->AddBuffer(*m_vb, 1, 2, GL_FLOAT, false, sizeof(SpriteVertex), (const void*)offsetof(SpriteVertex, u));
+    m_va->AddBuffer(*m_vb, 2, 1, GL_FLOAT, false, sizeof(SpriteVertex), (const void*)offsetof(SpriteVertex, alpha));
+    VertexArray::Unbind();
+    m_vertices.reserve(6 * 256);
+    m_initialized = true;
+}
+
+void SpriteBatch::Draw(const Texture& texture, const glm::vec3& topLeft, const glm::vec3& bottomRight,
+                       float angle, float alpha, const glm::vec4& uvRect) {
+    if (!texture) return;
+    if (!m_initialized) InitResources();
+    // 其他批处理器的数据先提交，保证绘制顺序
+    Renderer::Get().SetActiveBatcher(this, &SpriteBatch::FlushThunk);
+
+    // 与 Texture::Draw 的 translate * rotate * scale 相同，只是在CPU端完成
+    const glm::vec3 size = bottomRight - topLeft;
+    const glm::vec3 center = topLeft + size * 0.5f;
+    float c = 1.0f, s = 0.0f;
+    if (angle != 0.0f) {
+        const float radians = glm::radians(angle);
+        c = std::cos(radians);
+        s = std::sin(radians);
+    }
+
+    SpriteVertex corners[4];
+    for (int i = 0; i < 4; ++i) {
+        const float px = kCorners[i][0] * size.x;
+        const float py = kCorners[i][1] * size.y;
+        corners[i].x = center.x + px * c - py * s;
+        corners[i].y = center.y + px * s + py * c;
+        corners[i].u = uvRect.x + (uvRect.z - uvRect.x) * kCorners[i][2];
+        corners[i].v = uvRect.y + (uvRect.w - uvRect.y) * kCorners[i][3];
+        corners[i].alpha = alpha;
+    }
+
+    m_sprites.push_back({ texture.getTextureID(), static_cast<uint32_t>(m_vertices.size()) });
+    for (int index : kQuadOrder) {
+        m_vertices.push_back(corners[index]);
+    }
+    m_stats.sprites++;
+}
+
+void SpriteBatch::SetSortByTexture(bool enable) {
+    if (m_sortByTexture == enable) return;
+    Flush();
+    m_sortByTexture = enable;
+}
+
+void SpriteBatch::Flush() {
+    Renderer::Get().ReleaseBatcher(this);
+    if (m_sprites.empty()) return;
+
+    const std::vector<SpriteVertex>* vertices = &m_vertices;
+    if (m_sortByTexture) {
+        // 稳定排序：同一纹理内保持提交顺序
+        std::stable_sort(m_sprites.begin(), m_sprites.end(),
+            [](const QueuedSprite& a, const QueuedSprite& b) { return a.texture < b.texture; });
+        m_sorted.clear();
+        for (QueuedSprite& sprite : m_sprites) {
+            const uint32_t first = static_cast<uint32_t>(m_sorted.size());
+            m_sorted.insert(m_sorted.end(), m_vertices.begin() + sprite.first, m_vertices.begin() + sprite.first + 6);
+            sprite.first = first;
+        }
+        vertices = &m_sorted;
+    }
+
+    unsigned int bytes = static_cast<unsigned int>(vertices->size() * sizeof(SpriteVertex));
+    if (bytes > m_capacity) {
+        // 按倍数扩容，避免每帧重新分配
+        m_capacity = std::max(bytes, m_capacity * 2);
+    }
+    // 孤立旧存储后再写入，避免等待GPU读完上一批数据
+    m_vb->BufferData(nullptr, m_capacity, GL_STREAM_DRAW);
+    m_vb->BufferSubData(0, bytes, vertices->data());
+    m_stats.bufferUploads++;
+
+    GLStateCache& state = GLStateCache::Get();
+    state.SetBlend(true);
+    state.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    state.ActiveTexture(0);
+    m_shader.use();
+    m_va->Bind();
+    // 相同纹理的连续四边形合并为一次绘制
+    size_t runStart = 0;
+    for (size_t i = 1; i <= m_sprites.size(); ++i) {
+        if (i < m_sprites.size() && m_sprites[i].texture == m_sprites[runStart].texture) continue;
+        state.BindTexture(GL_TEXTURE_2D, m_sprites[runStart].texture);
+        GLCall(glDrawArrays(GL_TRIANGLES, static_cast<GLint>(m_sprites[runStart].first),
+                            static_cast<GLsizei>((i - runStart) * 6)));
+        m_stats.drawCalls++;
+        runStart = i;
+    }
+
+    m_sprites.clear();
+    m_vertices.clear();
+}
+
+void SpriteBatch::EndFrame() {
+    Flush();
+    m_lastStats = m_stats;
+    m_stats = SpriteBatchStats();
+}
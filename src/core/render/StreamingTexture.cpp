@@ -0,0 +1,418 @@
+#include <glad/glad.h>
+#include "core/render/StreamingTexture.h"
+#include "core/render/GLBase.h"
+#include "core/render/GLStateCache.h"
+#include "core/render/Renderer.h"
+#include "core/log.h"
+
+#include <cstring>
+
+using namespace core;
+
+namespace {
+// 缓冲区内每帧（以及帧内每个平面）的起始偏移对齐
+constexpr size_t kSlotAlignment = 256;
+// 定时帧的 pts 超前时钟超过此值（秒）视为时间轴跳变
+constexpr double kMaxLead = 1.0;
+
+size_t AlignUp(size_t value) {
+    return (value + kSlotAlignment - 1) & ~(kSlotAlignment - 1);
+}
+
+GLenum PlaneFormat(int channels) {
+    switch (channels) {
+    case 1: return GL_RED;
+    case 2: return GL_RG;
+    default: return GL_RGB;
+    }
+}
+
+GLenum PlaneInternalFormat(int channels) {
+    switch (channels) {
+    case 1: return GL_R8;
+    case 2: return GL_RG8;
+    default: return GL_RGB;
+    }
+}
+
+// Y 平面在 texture1，色度平面在 textureU / textureV（NV12 时 textureU 的 rg 为 UV）
+const std::string YuvFragmentShaderSource = R"(
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+uniform sampler2D texture1;
+uniform sampler2D textureU;
+uniform sampler2D textureV;
+uniform int interleaved = 0;
+uniform mat4 yuvToRgb;
+uniform float alpha = 1.0;
+
+void main()
+{
+    float y = texture(texture1, TexCoord).r;
+    vec2 uv = interleaved != 0
+        ? texture(textureU, TexCoord).rg
+        : vec2(texture(textureU, TexCoord).r, texture(textureV, TexCoord).r);
+    vec3 rgb = (yuvToRgb * vec4(y, uv, 1.0)).rgb;
+    FragColor = vec4(clamp(rgb, 0.0, 1.0), alpha);
+}
+)";
+}
+
+StreamingTexture::StreamingTexture(int width, int height, StreamFormat format, int slots)
+    : m_width(width), m_height(height), m_format(format) {
+    if (width <= 0 || height <= 0) {
+        Log << Level::Error << "StreamingTexture: invalid size " << width << "x" << height << op::endl;
+        return;
+    }
+    if (slots < 2) slots = 2;
+    m_slots.resize(static_cast<size_t>(slots));
+
+    // 色度平面宽高减半，奇数尺寸向上取整
+    const int chromaWidth = (width + 1) / 2;
+    const int chromaHeight = (height + 1) / 2;
+    switch (format) {
+    case StreamFormat::RGB24:
+        m_planes.push_back({ width, height, 3 });
+        break;
+    case StreamFormat::YUV420P:
+        m_planes.push_back({ width, height, 1 });
+        m_planes.push_back({ chromaWidth, chromaHeight, 1 });
+        m_planes.push_back({ chromaWidth, chromaHeight, 1 });
+        break;
+    case StreamFormat::NV12:
+        m_planes.push_back({ width, height, 1 });
+        m_planes.push_back({ chromaWidth, chromaHeight, 2 });
+        break;
+    }
+    m_frameBytes = 0;
+    for (StreamPlane& plane : m_planes) {
+        plane.offset = m_frameBytes;
+        m_frameBytes = AlignUp(m_frameBytes + static_cast<size_t>(plane.Stride()) * plane.height);
+    }
+
+    for (const StreamPlane& plane : m_planes) {
+        auto texture = std::make_shared<Texture>(plane.width, plane.height,
+            PlaneInternalFormat(plane.channels), PlaneFormat(plane.channels), false);
+        // 线性过滤时避免边缘采样到对侧像素
+        texture->bind();
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+        m_planeTextures.push_back(texture);
+    }
+    m_texture = m_planeTextures[0];
+
+    if (format != StreamFormat::RGB24) {
+        m_shader = std::make_shared<Shader>(Texture::DefaultVertexShader(), YuvFragmentShaderSource);
+        if (!*m_shader) {
+            Log << Level::Error << "StreamingTexture: YUV shader failed to compile" << op::endl;
+            m_texture.reset();
+            return;
+        }
+        m_texture->setCustomerShaderProgram(*m_shader);
+        m_texture->setCustomerTexture(1, "textureU", m_planeTextures[1]->getTextureID());
+        if (format == StreamFormat::YUV420P) {
+            m_texture->setCustomerTexture(2, "textureV", m_planeTextures[2]->getTextureID());
+        }
+        m_shader->Bind();
+        m_shader->setInt("interleaved", format == StreamFormat::NV12 ? 1 : 0);
+        SetColorSpace(false, false);
+    }
+
+    // 空后端的映射只是一块共享的临时内存，不能长期持有
+    const bool persistent = Renderer::Get().GetBackend() == Renderer::Backend::OpenGL
+        && (GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage);
+    if (persistent) {
+        const size_t slotBytes = m_frameBytes;
+        const size_t totalBytes = slotBytes * m_slots.size();
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        GLCall(glGenBuffers(1, &m_buffer));
+        GLStateCache::Get().BindBuffer(GL_PIXEL_UNPACK_BUFFER, m_buffer);
+        GLCall(glBufferStorage(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(totalBytes), nullptr, flags));
+        void* mapped = nullptr;
+        GLCall(mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(totalBytes), flags));
+        GLStateCache::Get().BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        if (mapped) {
+            m_mapped = static_cast<unsigned char*>(mapped);
+            for (size_t i = 0; i < m_slots.size(); ++i) {
+                m_slots[i].offset = i * slotBytes;
+            }
+        } else {
+            Log << Level::Warn << "StreamingTexture: persistent mapping failed, using client memory" << op::endl;
+            GLCall(glDeleteBuffers(1, &m_buffer));
+            GLStateCache::Get().OnBufferDeleted(m_buffer);
+            m_buffer = 0;
+        }
+    }
+    if (!m_mapped) {
+        for (Slot& slot : m_slots) {
+            slot.memory.resize(m_frameBytes);
+        }
+    }
+    Log << Level::Info << "StreamingTexture " << width << "x" << height << ", " << m_planes.size() << " planes, "
+        << m_slots.size() << " slots"
+        << (m_mapped ? " (persistent PBO)" : " (client memory)") << op::endl;
+}
+
+StreamingTexture::~StreamingTexture() {
+    for (Slot& slot : m_slots) {
+        if (slot.fence) {
+            GLCall(glDeleteSync(slot.fence));
+            slot.fence = nullptr;
+        }
+    }
+    if (m_buffer) {
+        GLStateCache::Get().BindBuffer(GL_PIXEL_UNPACK_BUFFER, m_buffer);
+        GLCall(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+        GLStateCache::Get().BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        GLCall(glDeleteBuffers(1, &m_buffer));
+        GLStateCache::Get().OnBufferDeleted(m_buffer);
+        m_buffer = 0;
+    }
+}
+
+unsigned char* StreamingTexture::SlotData(Slot& slot) {
+    return m_mapped ? m_mapped + slot.offset : slot.memory.data();
+}
+
+void StreamingTexture::SetColorSpace(bool bt709, bool fullRange) {
+    if (!m_shader || !*m_shader) return;
+    // R = Y' + kr*V'，G = Y' - kgu*U' - kgv*V'，B = Y' + kb*U'
+    const float kr = bt709 ? 1.5748f : 1.402f;
+    const float kgu = bt709 ? 0.187324f : 0.344136f;
+    const float kgv = bt709 ? 0.468124f : 0.714136f;
+    const float kb = bt709 ? 1.8556f : 1.772f;
+    // Y' = ys*(Y - yo)，U' = cs*(U - co)
+    const float ys = fullRange ? 1.0f : 255.0f / 219.0f;
+    const float yo = fullRange ? 0.0f : 16.0f / 255.0f;
+    const float cs = fullRange ? 1.0f : 255.0f / 224.0f;
+    const float co = 128.0f / 255.0f;
+
+    // glm 按列存储：第 0~2 列为 Y、U、V 的系数，第 3 列为常数项
+    glm::mat4 m(1.0f);
+    m[0] = glm::vec4(ys, ys, ys, 0.0f);
+    m[1] = glm::vec4(0.0f, -kgu * cs, kb * cs, 0.0f);
+    m[2] = glm::vec4(kr * cs, -kgv * cs, 0.0f, 0.0f);
+    m[3] = glm::vec4(-ys * yo - kr * cs * co,
+                     -ys * yo + (kgu + kgv) * cs * co,
+                     -ys * yo - kb * cs * co,
+                     1.0f);
+    m_shader->Bind();
+    m_shader->setMat4("yuvToRgb", m);
+}
+
+unsigned char* StreamingTexture::BeginWrite() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_slots.empty() || m_writing >= 0) return nullptr;
+    int index = -1;
+    for (size_t i = 0; i < m_slots.size(); ++i) {
+        if (m_slots[i].state == SlotState::Free) {
+            index = static_cast<int>(i);
+            break;
+        }
+    }
+    if (index < 0) {
+        // 没有空闲缓冲区：取代还没上传的那一帧
+        for (size_t i = 0; i < m_slots.size(); ++i) {
+            if (m_slots[i].state == SlotState::Ready) {
+                index = static_cast<int>(i);
+                m_stats.framesDropped++;
+                break;
+            }
+        }
+    }
+    if (index < 0) {
+        m_stats.framesDropped++;
+        return nullptr;
+    }
+    m_slots[index].state = SlotState::Writing;
+    m_writing = index;
+    return SlotData(m_slots[index]);
+}
+
+unsigned char* StreamingTexture::WaitWrite(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_slots.empty() || m_writing >= 0) return nullptr;
+    int index = -1;
+    auto findFree = [&] {
+        for (size_t i = 0; i < m_slots.size(); ++i) {
+            if (m_slots[i].state == SlotState::Free) {
+                index = static_cast<int>(i);
+                return true;
+            }
+        }
+        return false;
+    };
+    if (!m_slotFreed.wait_for(lock, timeout, findFree)) return nullptr;
+    m_slots[index].state = SlotState::Writing;
+    m_writing = index;
+    return SlotData(m_slots[index]);
+}
+
+void StreamingTexture::EndWrite() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_writing < 0) return;
+        // 只保留最新的一帧
+        for (Slot& slot : m_slots) {
+            if (slot.state == SlotState::Ready) {
+                slot.state = SlotState::Free;
+                m_stats.framesDropped++;
+            }
+        }
+        m_slots[m_writing].state = SlotState::Ready;
+        m_slots[m_writing].sequence = m_sequence++;
+        m_writing = -1;
+    }
+    m_slotFreed.notify_all();
+}
+
+void StreamingTexture::EndWrite(double pts) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_writing < 0) return;
+    Slot& slot = m_slots[m_writing];
+    slot.state = SlotState::Ready;
+    slot.pts = pts;
+    slot.sequence = m_sequence++;
+    m_writing = -1;
+}
+
+void StreamingTexture::CancelWrite() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_writing < 0) return;
+        m_slots[m_writing].state = SlotState::Free;
+        m_writing = -1;
+    }
+    m_slotFreed.notify_all();
+}
+
+void StreamingTexture::RetireSlots() {
+    bool freed = false;
+    for (Slot& slot : m_slots) {
+        if (slot.state != SlotState::InFlight) continue;
+        GLenum status = GL_ALREADY_SIGNALED;
+        if (slot.fence) {
+            GLCall(status = glClientWaitSync(slot.fence, 0, 0));
+            if (status == GL_TIMEOUT_EXPIRED) continue;
+            GLCall(glDeleteSync(slot.fence));
+            slot.fence = nullptr;
+        }
+        slot.state = SlotState::Free;
+        freed = true;
+    }
+    if (freed) m_slotFreed.notify_all();
+}
+
+int StreamingTexture::OldestReady() const {
+    int index = -1;
+    for (size_t i = 0; i < m_slots.size(); ++i) {
+        if (m_slots[i].state != SlotState::Ready) continue;
+        if (index < 0 || m_slots[i].sequence < m_slots[index].sequence) {
+            index = static_cast<int>(i);
+        }
+    }
+    return index;
+}
+
+bool StreamingTexture::PeekNext(double& next) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const int index = OldestReady();
+    if (index < 0) return false;
+    next = m_slots[index].pts;
+    return true;
+}
+
+bool StreamingTexture::Update() {
+    if (!m_texture) return false;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    RetireSlots();
+    // 未定时的写入只保留一帧
+    const int index = OldestReady();
+    if (index < 0) return false;
+    UploadSlot(index, lock);
+    return true;
+}
+
+bool StreamingTexture::Update(double clock) {
+    if (!m_texture) return false;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    RetireSlots();
+    // 按提交顺序取出已到期的帧，只上传其中最后一帧
+    int chosen = -1;
+    for (int index = OldestReady(); index >= 0; index = OldestReady()) {
+        const Slot& slot = m_slots[index];
+        if (slot.pts > clock && slot.pts - clock <= kMaxLead) break;
+        if (chosen >= 0) {
+            m_slots[chosen].state = SlotState::Free;
+            m_stats.framesLate++;
+        }
+        chosen = index;
+        // 暂时标记，使 OldestReady 跳过它
+        m_slots[chosen].state = SlotState::Writing;
+    }
+    if (chosen < 0) return false;
+    m_slotFreed.notify_all();
+    UploadSlot(chosen, lock);
+    return true;
+}
+
+void StreamingTexture::UploadSlot(int index, std::unique_lock<std::mutex>& lock) {
+    Slot& slot = m_slots[index];
+    slot.state = SlotState::InFlight;
+    lock.unlock();
+
+    if (m_mapped) {
+        GLStateCache::Get().BindBuffer(GL_PIXEL_UNPACK_BUFFER, m_buffer);
+        UploadPlanes(reinterpret_cast<const unsigned char*>(slot.offset));
+        // 解绑，否则之后的纹理上传会把指针当作缓冲区偏移
+        GLStateCache::Get().BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    } else {
+        // 客户端内存在调用返回时已被复制
+        UploadPlanes(slot.memory.data());
+    }
+
+    GLsync fence = nullptr;
+    if (m_mapped) {
+        GLCall(fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    }
+    lock.lock();
+    if (fence) {
+        slot.fence = fence;
+    } else {
+        slot.state = SlotState::Free;
+    }
+    m_hasFrame = true;
+    m_stats.framesUploaded++;
+    if (!fence) {
+        lock.unlock();
+        m_slotFreed.notify_all();
+    }
+}
+
+void StreamingTexture::Upload(const unsigned char* data) {
+    if (!m_texture || !data) return;
+    UploadPlanes(data);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_hasFrame = true;
+    m_stats.framesUploaded++;
+}
+
+void StreamingTexture::UploadPlanes(const unsigned char* pixels) {
+    // 纹理内容改变前先提交引用旧内容的绘制
+    Renderer::Get().FlushActiveBatcher();
+    GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+    for (size_t i = 0; i < m_planes.size(); ++i) {
+        const StreamPlane& plane = m_planes[i];
+        m_planeTextures[i]->bind();
+        GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, plane.width, plane.height, PlaneFormat(plane.channels),
+                               GL_UNSIGNED_BYTE, pixels + plane.offset));
+    }
+    GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+}
+
+StreamingTextureStats StreamingTexture::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
@@ -2,6 +2,8 @@
 
 #include "core/log.h"
 #include "core/render/GLBase.h"
+#include "core/render/GLStateCache.h"
+#include "core/render/Renderer.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <mutex>
 
@@ -9,6 +11,7 @@
 using namespace core;
 
 bool Texture::inited = false;
+unsigned int Texture::drawCalls = 0;
 std::shared_ptr<Shader> Texture::DefaultShaderProgram = nullptr;
 VertexArray* Texture::va = nullptr;
 VertexBuffer* Texture::vb = nullptr;
@@ -22,13 +25,15 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoord;
 
 uniform mat4 transform;
+uniform vec4 uvRect = vec4(0.0, 0.0, 1.0, 1.0);
 
 out vec2 TexCoord;
 
 void main()
 {
     gl_Position = transform * vec4(aPos, 1.0);
-    TexCoord = aTexCoord;
+    // 映射到图集中的子矩形
+    TexCoord = mix(uvRect.xy, uvRect.zw, aTexCoord);
 }
 )";
 
@@ -124,7 +129,11 @@ Texture::Texture(const unsigned char* data, int width, int height, bool isRGB)
     GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
 }
 
-Texture::Texture(const int width, const int height, bool isRGB)
+Texture::Texture(const int width, const int height, bool isRGB, bool mipmaps)
+    : Texture(width, height, isRGB ? GL_RGB : GL_RGBA, isRGB ? GL_RGB : GL_RGBA, mipmaps) {
+}
+
+Texture::Texture(const int width, const int height, unsigned int internalFormat, unsigned int format, bool mipmaps)
     : width(width), height(height), textureID(0) {
     init();
     GLCall(glGenTextures(1, &textureID));
@@ -133,23 +142,24 @@ Texture::Texture(const int width, const int height, bool isRGB)
         return;
     }
     bind();
-    if (isRGB) {
-        // 使用RGB格式
-        GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr));
+    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, nullptr));
+    if (mipmaps) {
+        GLCall(glGenerateMipmap(GL_TEXTURE_2D));
     } else {
-        // 使用RGBA格式
-        GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0));
     }
-    GLCall(glGenerateMipmap(GL_TEXTURE_2D));
     GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT));
     GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
-    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
     GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
 }
 
 Texture::~Texture() {
     if (textureID != 0) {
+        // 批处理器只保存纹理ID，删除前先提交引用它的绘制
+        Renderer::Get().FlushActiveBatcher();
         GLCall(glDeleteTextures(1, &textureID));
+        GLStateCache::Get().OnTextureDeleted(textureID);
     }
     textureID = 0;
 }
@@ -159,16 +169,35 @@ void Texture::bind() const {
         Log<<Level::Error<<"Texture::bind() textureID is 0"<<op::endl;
         return;
     }
-    GLCall(glActiveTexture(GL_TEXTURE0));
-    GLCall(glBindTexture(GL_TEXTURE_2D, textureID));
+    GLStateCache::Get().BindTexture(0, GL_TEXTURE_2D, textureID);
 }
 
-void Texture::Draw(const glm::vec3& topLeft, const glm::vec3& bottomRight, float angle, float alpha) const {
+void Texture::SubImage(int x, int y, int w, int h, const unsigned char* data) {
+    if (textureID == 0 || data == nullptr || w <= 0 || h <= 0) {
+        Log<<Level::Error<<"Texture::SubImage() invalid texture or region"<<op::endl;
+        return;
+    }
+    bind();
+    GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+    GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, w, h, GL_RGBA, GL_UNSIGNED_BYTE, data));
+    GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+}
+
+void Texture::GenerateMipmap() {
+    if (textureID == 0) return;
+    bind();
+    GLCall(glGenerateMipmap(GL_TEXTURE_2D));
+}
+
+void Texture::Draw(const glm::vec3& topLeft, const glm::vec3& bottomRight, float angle, float alpha, const glm::vec4& uvRect) const {
     if (textureID==0) {
         Log<<Level::Error<<"Texture::Draw() textureID is 0"<<op::endl;
         return;
     }
 
+    // 先提交批处理中的图元，保证绘制顺序
+    Renderer::Get().FlushActiveBatcher();
+
     std::shared_ptr<Shader> shader = customerShaderProgram ? customerShaderProgram : DefaultShaderProgram;
     shader->Bind();
     // 计算尺寸和中心点
@@ -186,12 +215,22 @@ void Texture::Draw(const glm::vec3& topLeft, const glm::vec3& bottomRight, float
     // 绑定纹理
     bind();
     shader->setInt("texture1", 0);
+    // 附加纹理（视频的色度平面等）绑定到之后的纹理单元
+    for (const CustomerTexture& extra : customerTextures) {
+        GLStateCache::Get().BindTexture(extra.unit, GL_TEXTURE_2D, extra.textureID);
+        shader->setInt(extra.sampler, static_cast<int>(extra.unit));
+    }
+    if (!customerTextures.empty()) {
+        GLStateCache::Get().ActiveTexture(0);
+    }
     // 设置透明度
     shader->setFloat("alpha", alpha);
+    // 采样区域（自定义着色器没有该uniform时忽略）
+    shader->setVec4("uvRect", uvRect);
 
     // 启用混合
-    GLCall(glEnable(GL_BLEND));
-    GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+    GLStateCache::Get().SetBlend(true);
+    GLStateCache::Get().BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     // 绘制
     if(customerVAO) {
@@ -206,9 +245,15 @@ void Texture::Draw(const glm::vec3& topLeft, const glm::vec3& bottomRight, float
         ib->Bind();
         GLCall(glDrawElements(GL_TRIANGLES, ib->getCount(), GL_UNSIGNED_INT, nullptr));
     }
-    // 解绑 VAO 和 IBO
-    VertexArray::Unbind();
-    IndexBuffer::Unbind();
+    drawCalls++;
+    // VAO 保持绑定：下一次绘制通过状态缓存判断是否需要重新绑定。
+    // 不再解绑 IBO，在已绑定的VAO上解绑会清除它的索引缓冲
+}
+
+unsigned int Texture::TakeDrawCalls() {
+    const unsigned int count = drawCalls;
+    drawCalls = 0;
+    return count;
 }
 
 bool Texture::setCustomerShaderProgram(const std::string& vertexShader, const std::string& fragmentShader) {
@@ -235,6 +280,21 @@ bool Texture::setCustomerShaderProgram(const Shader& shader) {
     return true;
 }
 
+void Texture::setCustomerTexture(unsigned int unit, const std::string& sampler, unsigned int textureID) {
+    for (CustomerTexture& extra : customerTextures) {
+        if (extra.unit == unit) {
+            extra.sampler = sampler;
+            extra.textureID = textureID;
+            return;
+        }
+    }
+    customerTextures.push_back({ unit, sampler, textureID });
+}
+
+const std::string& Texture::DefaultVertexShader() {
+    return DefaultVertexShaderSource;
+}
+
 void Texture::setCustomerVertexArray(const VertexArray& va) {
     if (customerVAO) 
         customerVAO.reset();
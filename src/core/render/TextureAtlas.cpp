@@ -0,0 +1,92 @@
+#include "core/render/TextureAtlas.h"
+#include "core/log.h"
+#include "core/render/GLBase.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+using namespace core;
+
+TextureAtlas& TextureAtlas::Get() {
+    static TextureAtlas instance;
+    return instance;
+}
+
+TextureAtlas::TextureAtlas()
+    : packer(PageSize, std::numeric_limits<uint32_t>::max(), Padding) {
+}
+
+bool TextureAtlas::Accepts(int width, int height) const {
+    return width > 0 && height > 0 && width <= MaxSpriteSize && height <= MaxSpriteSize;
+}
+
+std::shared_ptr<Texture> TextureAtlas::CreatePage() {
+    auto page = std::make_shared<Texture>(PageSize, PageSize);
+    if (!*page) return nullptr;
+    page->bind();
+    // 图集页不能平铺；mipmap 只生成到边距仍能覆盖的级别
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 2));
+    Log << Level::Info << "TextureAtlas created page " << pages.size() << op::endl;
+    return page;
+}
+
+bool TextureAtlas::Add(const unsigned char* rgba, int width, int height, Sprite& out) {
+    if (!rgba || !Accepts(width, height)) return false;
+
+    GlyphAtlas::Allocation alloc;
+    if (!packer.Allocate(width, height, alloc)) {
+        return false;
+    }
+    if (alloc.page >= pages.size()) {
+        pages.resize(alloc.page + 1);
+        dirty.resize(alloc.page + 1, false);
+    }
+    if (!pages[alloc.page]) {
+        pages[alloc.page] = CreatePage();
+        if (!pages[alloc.page]) {
+            Log << Level::Error << "TextureAtlas::Add() failed to create page texture" << op::endl;
+            return false;
+        }
+    }
+
+    // 复制图像并把边缘像素向外扩展到边距中
+    const int paddedWidth = width + Padding * 2;
+    const int paddedHeight = height + Padding * 2;
+    scratch.resize(static_cast<size_t>(paddedWidth) * paddedHeight * 4);
+    for (int row = 0; row < paddedHeight; ++row) {
+        int srcRow = std::clamp(row - Padding, 0, height - 1);
+        const unsigned char* src = rgba + static_cast<size_t>(srcRow) * width * 4;
+        unsigned char* dst = scratch.data() + static_cast<size_t>(row) * paddedWidth * 4;
+        for (int col = 0; col < Padding; ++col) {
+            std::memcpy(dst + col * 4, src, 4);
+            std::memcpy(dst + (Padding + width + col) * 4, src + (width - 1) * 4, 4);
+        }
+        std::memcpy(dst + Padding * 4, src, static_cast<size_t>(width) * 4);
+    }
+    pages[alloc.page]->SubImage(alloc.x - Padding, alloc.y - Padding, paddedWidth, paddedHeight, scratch.data());
+
+    if (!dirty[alloc.page]) {
+        dirty[alloc.page] = true;
+        dirtyCount++;
+    }
+    spriteCount++;
+
+    const float inv = 1.0f / static_cast<float>(PageSize);
+    out.texture = pages[alloc.page];
+    out.page = alloc.page;
+    out.uv = glm::vec4(alloc.x * inv, alloc.y * inv, (alloc.x + width) * inv, (alloc.y + height) * inv);
+    return true;
+}
+
+void TextureAtlas::Commit() {
+    if (dirtyCount == 0) return;
+    for (size_t i = 0; i < pages.size(); ++i) {
+        if (!dirty[i]) continue;
+        if (pages[i]) pages[i]->GenerateMipmap();
+        dirty[i] = false;
+    }
+    dirtyCount = 0;
+}
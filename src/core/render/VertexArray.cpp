@@ -46,7 +46,7 @@ VertexArray::VertexArray(const VertexArray& va) {
             Bind();
             
             // 绑定相同的VBO
-            GLCall(glBindBuffer(GL_ARRAY_BUFFER, currentVBO));
+            GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, currentVBO);
             
             // 复制属性配置到我们的VAO
             GLCall(glEnableVertexAttribArray(i));
@@ -72,13 +72,14 @@ VertexArray::VertexArray(const VertexArray& va) {
         GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementArrayBufferBinding));
     }
       // 恢复原来绑定的VAO
-    GLCall(glBindVertexArray(previousVAO));
+    GLStateCache::Get().BindVertexArray(previousVAO);
     Log<<Level::Info<<"VertexArray::VertexArray(const VertexArray& va) finished "<<rendererID<<op::endl;
 }
 
 VertexArray::~VertexArray() {
     if (rendererID != 0) {
         GLCall(glDeleteVertexArrays(1, &rendererID));
+        GLStateCache::Get().OnVertexArrayDeleted(rendererID);
     }
     rendererID = 0;
 }
@@ -112,6 +113,7 @@ VertexArray& VertexArray::operator=(const VertexArray& va) {
         // 先删除当前的VAO
         if(rendererID != 0) {
             GLCall(glDeleteVertexArrays(1, &rendererID));
+            GLStateCache::Get().OnVertexArrayDeleted(rendererID);
         }
         
         // 生成新的顶点数组对象
@@ -150,7 +152,7 @@ VertexArray& VertexArray::operator=(const VertexArray& va) {
                 Bind();
                 
                 // 绑定相同的VBO
-                GLCall(glBindBuffer(GL_ARRAY_BUFFER, currentVBO));
+                GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, currentVBO);
                 
                 // 复制属性配置到我们的VAO
                 GLCall(glEnableVertexAttribArray(i));
@@ -177,7 +179,7 @@ VertexArray& VertexArray::operator=(const VertexArray& va) {
         }
         
         // 恢复原来绑定的VAO
-        GLCall(glBindVertexArray(previousVAO));
+        GLStateCache::Get().BindVertexArray(previousVAO);
     }
     Log<<Level::Info<<"VertexArray& VertexArray::operator=(const VertexArray& va) finished "<<this->rendererID<<op::endl;
     return *this;
@@ -29,7 +29,7 @@ VertexBuffer::VertexBuffer(const VertexBuffer& vb) : size(vb.size) {
     GLCall(glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &previousBuffer));
     
     // 绑定源缓冲区并获取数据
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, vb.rendererID));
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, vb.rendererID);
     void* data = nullptr;
     
     // 只有在缓冲区有大小时才分配内存
@@ -42,7 +42,7 @@ VertexBuffer::VertexBuffer(const VertexBuffer& vb) : size(vb.size) {
     }
     
     // 绑定新缓冲区并复制数据
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, rendererID));
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, rendererID);
     GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
     
     // 释放临时数据
@@ -50,7 +50,7 @@ VertexBuffer::VertexBuffer(const VertexBuffer& vb) : size(vb.size) {
         free(data);
     }
       // 恢复之前绑定的缓冲区
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, previousBuffer));
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, previousBuffer);
     Log<<Level::Info<<"VertexBuffer::VertexBuffer(const VertexBuffer& vb) finished "<<rendererID<<op::endl;
 }
 
@@ -58,6 +58,7 @@ VertexBuffer::~VertexBuffer() {
     if (rendererID != 0) {
         try {
             GLCall(glDeleteBuffers(1, &rendererID));
+            GLStateCache::Get().OnBufferDeleted(rendererID);
         } catch (const std::exception& e) {
             Log << Level::Error << "Exception while deleting vertex buffer " << rendererID << ": " << e.what() << op::endl;
         } catch (...) {
@@ -68,13 +69,14 @@ VertexBuffer::~VertexBuffer() {
     }
 }
 
-void VertexBuffer::BufferData(const void* data, unsigned int size) {
+void VertexBuffer::BufferData(const void* data, unsigned int size, unsigned int usage) {
     if (rendererID == 0) {
         Log<<Level::Error<<"VertexBuffer::BufferData() rendererID is 0"<<op::endl;
         return;
     }
+    this->size = size;
     Bind();
-    GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
+    GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, usage));
     Unbind();
 }
 
@@ -94,13 +96,14 @@ VertexBuffer& VertexBuffer::operator=(const VertexBuffer& vb) {
         // 先删除当前的缓冲区
         if (rendererID != 0) {
             GLCall(glDeleteBuffers(1, &rendererID));
+            GLStateCache::Get().OnBufferDeleted(rendererID);
         }
         
         // 生成新的缓冲区ID
         GLCall(glGenBuffers(1, &rendererID));
         
         // 绑定源缓冲区并获取数据
-        GLCall(glBindBuffer(GL_ARRAY_BUFFER, vb.rendererID));
+        GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, vb.rendererID);
         void* data = nullptr;
         
         // 只有在缓冲区有大小时才分配内存
@@ -113,7 +116,7 @@ VertexBuffer& VertexBuffer::operator=(const VertexBuffer& vb) {
         }
         
         // 绑定新缓冲区并复制数据
-        GLCall(glBindBuffer(GL_ARRAY_BUFFER, rendererID));
+        GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, rendererID);
         GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
         
         // 释放临时数据
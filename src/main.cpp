@@ -6,6 +6,7 @@
 #include "core/screen/mainScreen.h"
 #include <tinyfiledialogs.h>
 #include "core/render/OpenGLFontRenderer.h"
+#include "core/render/FramePacer.h"
 #include "core/baseItem/Font.h"
 #include "custom.h"
 
@@ -102,7 +103,7 @@ int init(){
     
     // 设置当前上下文
     glfwMakeContextCurrent(WindowInfo.window);
-    glfwSwapInterval(Config::getInstance()->getBool(VERTICAL_SYNC)); // 垂直同步
+    core::FramePacer::Get().SetVSync(Config::getInstance()->getBool(VERTICAL_SYNC)); // 垂直同步
     Log<<Level::Info<<"Loading GLAD"<<op::endl;
     // 初始化glad
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
@@ -140,6 +141,7 @@ int init(){
     glfwSetKeyCallback(WindowInfo.window, KeyEvent);
     glfwSetCharCallback(WindowInfo.window, CharEvent); // 设置Unicode字符输入回调
     glfwSetFramebufferSizeCallback(WindowInfo.window, framebuffer_size_callback);
+    glfwSetWindowRefreshCallback(WindowInfo.window, WindowRefreshEvent);
     // 打印OpenGL版本
     {
         const GLubyte* version = glGetString(GL_VERSION);
@@ -12,6 +12,14 @@
 #include "core/baseItem/Base.h"
 #include "core/screen/mainScreen.h"
 #include "core/render/Drawer.h"
+#include "core/baseItem/Font.h"
+#include "core/render/Renderer.h"
+#include "core/render/SpriteBatch.h"
+#include "core/render/GLStateCache.h"
+#include "core/render/FrameStats.h"
+#include "core/render/Profiler.h"
+#include "core/render/FramePacer.h"
+#include "core/render/DamageTracker.h"
 
 using namespace core;
 
@@ -20,6 +28,11 @@ double lastFPSUpdateTime = 0.0;
 int frameCount = 0;
 double currentFPS = 0.0;
 
+// 窗口内容需要重绘（被遮挡后恢复等）
+void WindowRefreshEvent(GLFWwindow* window) {
+    DamageTracker::Get().Invalidate();
+}
+
 // 窗口大小改变时的回调函数
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
     // 更新screenInfo的相关变量
@@ -29,6 +42,7 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
     
     // 设置OpenGL视口大小
     core::RenderAPI::Get().Viewport(0, 0, width, height);
+    DamageTracker::Get().Invalidate();
     
     Log << Level::Info << "Window resized to " << width << "x" << height << op::endl;
 }
@@ -38,17 +52,39 @@ int mainloop() {
     const int MAX_CONSECUTIVE_ERRORS = 10;
     
     try {
+        // 上传后台光栅化完成的字形
+        Font::ProcessRasterizedGlyphs();
+
+        // FPS与分析器叠加层每帧都在变化
+        if (bools[boolconfig::show_fps] || bools[boolconfig::show_profiler]) {
+            DamageTracker::Get().Invalidate();
+        }
+        int width, height;
+        glfwGetFramebufferSize(WindowInfo.window, &width, &height);
+        const RedrawPlan plan = DamageTracker::Get().BeginFrame(width, height);
+        if (!plan.redraw) {
+            // 没有变化：不绘制也不交换，阻塞到下一个事件或 Invalidate
+            DamageTracker::Get().WaitEvents();
+            FramePacer::Get().OnInputPolled();
+            consecutiveErrors = 0;
+            return 0;
+        }
+
+        Profiler::Get().SetGpuTiming(bools[boolconfig::show_profiler]);
+        Profiler::Get().BeginFrame();
+
+        // 设置视口和投影矩阵（如果需要）
+        core::RenderAPI::Get().Viewport(0, 0, width, height);
+        // 局部重绘：清除与绘制都限制在损坏区域内
+        if (plan.scissor) {
+            core::RenderAPI::Get().SetScissor(plan.x, plan.y, plan.width, plan.height);
+        }
         
         core::RenderAPI::Get().ClearColor(0.2f, 0.2f, 0.2f, 1.0f);
             
         // 清除颜色和深度缓冲区
         core::RenderAPI::Get().Clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // 设置视口和投影矩阵（如果需要）
-        int width, height;
-        glfwGetFramebufferSize(WindowInfo.window, &width, &height);
-        core::RenderAPI::Get().Viewport(0, 0, width, height);
-
         // FPS计算
         // 获取当前时间
         double currentTime = glfwGetTime();
@@ -65,11 +101,41 @@ int mainloop() {
             std::stringstream ss;
             ss << std::fixed << std::setprecision(1) << currentFPS;
             Log << Level::Debug << "FPS: " << ss.str() << op::endl;
+            const DrawerFrameStats& drawerStats = Drawer::getInstance()->GetLastFrameStats();
+            Log << Level::Debug << "Drawer: " << drawerStats.primitives << " primitives, "
+                << drawerStats.drawCalls << " draws, " << drawerStats.bufferUploads << " uploads, "
+                << drawerStats.vertices << " vertices" << op::endl;
+            const SpriteBatchStats& spriteStats = SpriteBatch::Get().GetLastFrameStats();
+            Log << Level::Debug << "SpriteBatch: " << spriteStats.sprites << " sprites, "
+                << spriteStats.drawCalls << " draws, " << spriteStats.bufferUploads << " uploads" << op::endl;
+            const UniformStats& uniformStats = Shader::GetUniformStats();
+            Log << Level::Debug << "Uniforms: " << uniformStats.callsIssued << " issued, "
+                << uniformStats.callsElided << " elided, " << uniformStats.lookupsAvoided << " lookups avoided" << op::endl;
+            Shader::ResetUniformStats();
+            const GLStateStats& stateStats = GLStateCache::Get().GetStats();
+            Log << Level::Debug << "GL state: " << stateStats.issued << " issued, "
+                << stateStats.elided << " elided" << op::endl;
+            GLStateCache::Get().ResetStats();
+            if (DamageTracker::Get().IsOnDemand()) {
+                const DamageStats& damageStats = DamageTracker::Get().GetStats();
+                Log << Level::Debug << "On-demand: " << damageStats.framesRendered << " rendered, "
+                    << damageStats.framesPartial << " partial, " << damageStats.idleWaits << " idle waits" << op::endl;
+                DamageTracker::Get().ResetStats();
+            }
+            const FramePacerStats& pacerStats = FramePacer::Get().GetStats();
+            Log << Level::Debug << "Frame pacing: latency " << (pacerStats.gpuTimestamps ? "" : "<= ") << pacerStats.latencyMs << " ms (avg "
+                << pacerStats.averageLatencyMs << " ms), " << pacerStats.framesInFlight << " in flight, fence wait "
+                << pacerStats.fenceWaitMs << " ms, limiter " << pacerStats.limiterSleepMs << " ms" << op::endl;
+            const FrameDrawStats& drawStats = FrameStats::Get().GetLastFrame();
+            Log << Level::Debug << "Draws: " << drawStats.drawCalls << " (" << drawStats.primitiveDraws << " primitive, "
+                << drawStats.spriteDraws << " sprite, " << drawStats.textDraws << " text, "
+                << drawStats.textureDraws << " texture)" << op::endl;
             Log<<Level::Info<<"Current screen :"<<(int)screen::Screen::getCurrentScreen()->getID()<<op::endl;
         }
         // 绘制场景
         // 使用屏幕管理系统的当前屏幕
         if (screen::Screen::getCurrentScreen()) {
+            PROFILE_SCOPE("screen draw");
             screen::Screen::getCurrentScreen()->Draw();
             if(bools[boolconfig::debug]) {
                 for(auto i=0;i<=4000;i+=50) {
@@ -94,13 +160,39 @@ int mainloop() {
                 (*font)->RenderText(fpsText, 0, 0, 0.5f, color::black);
             }
         }
-        // 确保所有 OpenGL 命令完成
-        core::RenderAPI::Get().Finish();
-        // 安全地交换缓冲区
-        core::RenderAPI::Get().SwapBuffers(WindowInfo.window);
+        // 如果启用了分析器叠加层，绘制帧时间百分位与耗时最多的区域
+        if (bools[boolconfig::show_profiler]) {
+            Font** font = Explorer::getInstance()->getFontPtr(FontID::Default);
+            if (font && *font) {
+                Profiler::Get().DrawOverlay(**font);
+            }
+        }
+        // 提交本帧剩余的批处理图元
+        {
+            PROFILE_SCOPE("render submit");
+            FrameStats::Get().EndFrame();
+        }
+        if (plan.scissor) {
+            core::RenderAPI::Get().DisableScissor();
+        }
+        {
+            PROFILE_SCOPE("swap");
+            // 安全地交换缓冲区
+            core::RenderAPI::Get().SwapBuffers(WindowInfo.window);
+        }
+        {
+            // 不再每帧 glFinish：由栅栏限制在途帧数，并按目标帧率等待
+            PROFILE_SCOPE("frame pacing");
+            FramePacer::Get().EndFrame();
+        }
 
         // 处理事件
-        glfwPollEvents();
+        {
+            PROFILE_SCOPE("poll events");
+            glfwPollEvents();
+            FramePacer::Get().OnInputPolled();
+        }
+        Profiler::Get().EndFrame();
         
         consecutiveErrors = 0; // 重置错误计数
         
@@ -123,6 +215,8 @@ int mainloop() {
 }
 
 void KeyEvent(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    // 输入可能改变任何界面状态，整窗重绘
+    DamageTracker::Get().Invalidate();
     switch (action) {
         case GLFW_PRESS:
         case GLFW_REPEAT:
@@ -169,6 +263,19 @@ void KeyEvent(GLFWwindow* window, int key, int scancode, int action, int mods) {
                         Log << Level::Info << "FPS display " << (bools[boolconfig::show_fps] ? "enabled" : "disabled") << op::endl;
                     }
                     break;
+                case GLFW_KEY_F6:
+                    // 按Ctrl+F6切换帧时间分析器叠加层
+                    if (mods & GLFW_MOD_CONTROL) {
+                        bools[boolconfig::show_profiler] = !bools[boolconfig::show_profiler];
+                        Log << Level::Info << "Profiler overlay " << (bools[boolconfig::show_profiler] ? "enabled" : "disabled") << op::endl;
+                    }
+                    break;
+                case GLFW_KEY_F7:
+                    // 按Ctrl+F7导出最近的帧时间记录（Chrome trace 格式）
+                    if (mods & GLFW_MOD_CONTROL) {
+                        Profiler::Get().ExportChromeTrace("files/profile/trace_" + std::to_string(static_cast<long long>(glfwGetTime() * 1000)) + ".json");
+                    }
+                    break;
                 case GLFW_KEY_F2:
                     // 按F2切换编辑模式
                     {
@@ -193,6 +300,7 @@ void KeyEvent(GLFWwindow* window, int key, int scancode, int action, int mods) {
 }
 
 void MouseButtonEvent(GLFWwindow* window, int button, int action, int mods) {
+    DamageTracker::Get().Invalidate();
     double x, y;
     glfwGetCursorPos(window, &x, &y);
     auto currentScreen = screen::Screen::getCurrentScreen();
@@ -238,11 +346,13 @@ void MouseMoveEvent(GLFWwindow* window, double xpos, double ypos) {
         int mouseX = static_cast<int>(xpos);
         int mouseY = static_cast<int>(ypos);
         currentScreen->OnEditMouseMove(mouseX, mouseY);
+        DamageTracker::Get().Invalidate();
     }
 }
 
 // 处理Unicode字符输入的回调函数（支持中文等多字节字符）
 void CharEvent(GLFWwindow* window, unsigned int codepoint) {
+    DamageTracker::Get().Invalidate();
     // 将Unicode码点转换为UTF-8字符串
     std::string utf8_char;
     
@@ -0,0 +1,105 @@
+// 无窗口冒烟测试：在空渲染后端上绘制一段文字和一个按钮，检查提交给驱动的调用计数。
+// 用法：NullBackendTest [字体文件]；找不到字体时返回 77，CTest 记为跳过
+#include <glad/glad.h>
+#include "core/render/NullBackend.h"
+#include "core/render/FrameStats.h"
+#include "core/render/OpenGLFontRenderer.h"
+#include "core/render/Renderer.h"
+#include "core/baseItem/Base.h"
+#include "core/baseItem/Button.h"
+#include "core/baseItem/Font.h"
+#include "core/Config.h"
+#include "core/configItem.h"
+#include "core/log.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+using namespace core;
+
+namespace {
+
+int failures = 0;
+// 与 CMake 中 SKIP_RETURN_CODE 一致：缺少测试字体时跳过而不是失败
+constexpr int kSkipReturnCode = 77;
+
+void Check(bool condition, const char* what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAILED: %s\n", what);
+        failures++;
+    }
+}
+
+// 测试中不创建资源管理器，直接为按钮指定字体
+class TestButton : public Button {
+public:
+    using Button::Button;
+    void SetFont(Font** font) { fontPtr = font; }
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::string fontPath = argc > 1 ? argv[1] : "files/fonts/spare.ttf";
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(fontPath, ec)) {
+        std::printf("SKIPPED: test font %s not found (set HEADLESS_TEST_FONT)\n", fontPath.c_str());
+        return kSkipReturnCode;
+    }
+
+    Check(NullBackend::Initialize(), "NullBackend::Initialize()");
+    Check(Renderer::Get().GetBackend() == Renderer::Backend::Null, "renderer backend is Null");
+    WindowInfo.width = 800;
+    WindowInfo.height = 600;
+
+    static OpenGLFontRenderer fontRenderer;
+    Check(fontRenderer.Initialize(nullptr), "OpenGLFontRenderer::Initialize()");
+    Font::SetFontRenderer(&fontRenderer);
+    // 同步光栅化，第一帧就能绘制真实字形；不读写磁盘缓存
+    Font::SetAsyncRasterization(false);
+    Config::getInstance()->set(GLYPH_CACHE, false);
+
+    auto font = std::make_unique<Font>(fontPath, false, 32);
+    Font* fontRaw = font.get();
+    Check(font->isLoaded(), "font loaded");
+
+    TestButton button("Start", FontID::Default, Region(100, 100, 300, 160, false));
+    button.SetFont(&fontRaw);
+    button.SetEnableBitmap(false);
+    button.SetEnableFill(true);
+
+    NullBackend::ResetStats();
+    font->RenderText("Hello, PlaneWeaver", 10.0f, 10.0f, 1.0f, glm::vec4(1.0f));
+    button.Draw();
+    FrameStats::Get().EndFrame();
+
+    const NullBackendStats& stats = NullBackend::GetStats();
+    std::printf("draws %llu, vertices %llu, state changes %llu, uniforms %llu, buffer uploads %llu (%llu bytes), "
+                "texture uploads %llu (%llu bytes)\n",
+                stats.drawCalls, stats.vertices, stats.stateChanges, stats.uniformUploads,
+                stats.bufferUploads, stats.bufferUploadBytes, stats.textureUploads, stats.textureUploadBytes);
+
+    // 文字（两段，同一图集页）与按钮底色各至少一次绘制
+    Check(stats.drawCalls >= 2, "text and button fill were drawn");
+    Check(stats.vertices > 0, "vertices were submitted");
+    Check(stats.bufferUploads > 0, "vertex data was uploaded");
+    Check(stats.textureUploads > 0, "glyphs were uploaded to the atlas");
+    // 各绘制路径汇总的次数与驱动实际收到的一致
+    Check(FrameStats::Get().GetLastFrame().drawCalls == stats.drawCalls, "frame draw tally matches the backend");
+
+    // 第二帧：字形已在图集中，排版缓存命中，不再上传纹理
+    NullBackend::ResetStats();
+    font->RenderText("Hello, PlaneWeaver", 10.0f, 10.0f, 1.0f, glm::vec4(1.0f));
+    button.Draw();
+    FrameStats::Get().EndFrame();
+    Check(NullBackend::GetStats().drawCalls >= 2, "second frame drew again");
+    Check(NullBackend::GetStats().textureUploads == 0, "second frame uploaded no glyphs");
+
+    font.reset();
+    if (failures == 0) {
+        std::printf("NullBackendTest passed\n");
+    }
+    return failures == 0 ? 0 : 1;
+}